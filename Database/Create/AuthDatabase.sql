@@ -34,8 +34,10 @@ CREATE TABLE `realmlist` (
     `category` TINYINT UNSIGNED NOT NULL DEFAULT '0',
     `population` FLOAT UNSIGNED NOT NULL DEFAULT '0',
     `build` INT UNSIGNED NOT NULL DEFAULT '5875',
+    `updated_at` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
     PRIMARY KEY (`id`),
-    UNIQUE KEY `index_name` (`name`)
+    UNIQUE KEY `index_name` (`name`),
+    KEY `index_updated_at` (`updated_at`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8;
 
 DROP TABLE IF EXISTS `characters`;
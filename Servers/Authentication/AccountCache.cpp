@@ -0,0 +1,161 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Authentication/AccountCache.hpp>
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace Authentication
+{
+    AccountCache *AccountCache::m_instance = nullptr;
+
+    AccountCache *AccountCache::instance()
+    {
+        if (!m_instance)
+            m_instance = new AccountCache();
+        return m_instance;
+    }
+
+    AccountCache::Lookup AccountCache::find(const std::string &username, Record &record)
+    {
+        auto key = normalize(username);
+        auto &shard = shard_for(key);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+        {
+            shard.statistics.misses++;
+            return Lookup::miss;
+        }
+
+        auto node = it->second;
+        if (node->expires <= std::chrono::steady_clock::now())
+        {
+            shard.index.erase(it);
+            shard.entries.erase(node);
+            shard.statistics.expirations++;
+            shard.statistics.misses++;
+            return Lookup::miss;
+        }
+
+        shard.entries.splice(shard.entries.begin(), shard.entries, node);
+        if (!node->exists)
+        {
+            shard.statistics.negative_hits++;
+            return Lookup::unknown;
+        }
+
+        shard.statistics.hits++;
+        record = node->record;
+        return Lookup::found;
+    }
+
+    void AccountCache::insert(const std::string &username, const Record &record)
+    {
+        store(username, &record, time_to_live);
+    }
+
+    void AccountCache::insert_unknown(const std::string &username) { store(username, nullptr, negative_time_to_live); }
+
+    void AccountCache::invalidate(const std::string &username)
+    {
+        auto key = normalize(username);
+        auto &shard = shard_for(key);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+            return;
+
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+        shard.statistics.invalidations++;
+    }
+
+    void AccountCache::invalidate_all()
+    {
+        for (auto &shard : m_shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            shard.statistics.invalidations += shard.entries.size();
+            shard.entries.clear();
+            shard.index.clear();
+        }
+    }
+
+    AccountCache::Statistics AccountCache::statistics() const
+    {
+        Statistics statistics;
+        for (auto &shard : m_shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            statistics.hits += shard.statistics.hits;
+            statistics.negative_hits += shard.statistics.negative_hits;
+            statistics.misses += shard.statistics.misses;
+            statistics.evictions += shard.statistics.evictions;
+            statistics.expirations += shard.statistics.expirations;
+            statistics.invalidations += shard.statistics.invalidations;
+            statistics.size += shard.entries.size();
+        }
+        return statistics;
+    }
+
+    void AccountCache::store(const std::string &username, const Record *record, std::chrono::steady_clock::duration ttl)
+    {
+        auto key = normalize(username);
+        auto &shard = shard_for(key);
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end())
+        {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        }
+        else
+        {
+            if (shard.entries.size() >= capacity / shard_count)
+            {
+                shard.index.erase(shard.entries.back().key);
+                shard.entries.pop_back();
+                shard.statistics.evictions++;
+            }
+
+            shard.entries.push_front({key, {}, false, {}});
+            shard.index.emplace(key, shard.entries.begin());
+        }
+
+        auto &node = shard.entries.front();
+        node.exists = record;
+        node.record = record ? *record : Record{};
+        node.expires = std::chrono::steady_clock::now() + ttl;
+    }
+
+    AccountCache::Shard &AccountCache::shard_for(const std::string &key)
+    {
+        return m_shards[std::hash<std::string>{}(key) % shard_count];
+    }
+
+    std::string AccountCache::normalize(const std::string &username)
+    {
+        // Usernames are compared case insensitively by the account table collation
+        auto key = username;
+        std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::toupper(c); });
+        return key;
+    }
+} // namespace Authentication
@@ -0,0 +1,108 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Crypto/Srp6.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Authentication
+{
+    class AccountCache
+    {
+    public:
+        struct Record
+        {
+            std::uint32_t id{0};
+            std::string username;
+            Crypto::Srp6::Salt salt{};
+            Crypto::Srp6::Verifier verifier{};
+        };
+
+        enum class Lookup
+        {
+            miss,
+            found,
+            unknown
+        };
+
+        struct Statistics
+        {
+            std::uint64_t hits{0};
+            std::uint64_t negative_hits{0};
+            std::uint64_t misses{0};
+            std::uint64_t evictions{0};
+            std::uint64_t expirations{0};
+            std::uint64_t invalidations{0};
+            std::size_t size{0};
+
+            double hit_rate() const
+            {
+                auto lookups = hits + negative_hits + misses;
+                return lookups ? double(hits + negative_hits) / double(lookups) : 0.0;
+            }
+        };
+
+        static AccountCache *instance();
+
+        Lookup find(const std::string &username, Record &record);
+        void insert(const std::string &username, const Record &record);
+        void insert_unknown(const std::string &username);
+        void invalidate(const std::string &username);
+        void invalidate_all();
+
+        Statistics statistics() const;
+
+    private:
+        static constexpr std::size_t shard_count = 16;
+        static constexpr std::size_t capacity = 16384;
+        static constexpr auto time_to_live = std::chrono::minutes(5);
+        static constexpr auto negative_time_to_live = std::chrono::seconds(30);
+
+        struct Node
+        {
+            std::string key;
+            Record record;
+            bool exists{false};
+            std::chrono::steady_clock::time_point expires;
+        };
+
+        struct Shard
+        {
+            mutable std::mutex lock;
+            std::list<Node> entries;
+            std::unordered_map<std::string, std::list<Node>::iterator> index;
+            Statistics statistics;
+        };
+
+        static AccountCache *m_instance;
+
+        std::array<Shard, shard_count> m_shards;
+
+        AccountCache() = default;
+
+        void store(const std::string &username, const Record *record, std::chrono::steady_clock::duration ttl);
+        Shard &shard_for(const std::string &key);
+        static std::string normalize(const std::string &username);
+    };
+} // namespace Authentication
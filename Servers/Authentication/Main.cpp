@@ -20,8 +20,10 @@
 #include <Database/AuthDatabase.hpp>
 #include <Realm/RealmList.hpp>
 #include <Utilities/Log.hpp>
+#include <algorithm>
 #include <boost/asio/signal_set.hpp>
 #include <openssl/provider.h>
+#include <thread>
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
 OSSL_PROVIDER *LegacyProvider;
@@ -40,15 +42,18 @@ int main()
         Utilities::Log::init();
 
         auto auth_database = Database::AuthDatabase::instance();
-        auth_database->open();
+        auth_database->open(4);
 
         auto io_context = std::make_shared<boost::asio::io_context>();
 
         auto realm_list = Realm::RealmList::instance();
         realm_list->init(*io_context);
 
+        Crypto::Srp6::init();
+
+        auto network_threads = int(std::max(1u, std::thread::hardware_concurrency()));
         auto session_manager = Authentication::SessionManager::instance();
-        if (!session_manager->init(*io_context, "0.0.0.0", 3724, 1))
+        if (!session_manager->init(*io_context, "0.0.0.0", 3724, network_threads))
         {
             LOG_CRITICAL("Unable to initialize session manager");
             return EXIT_FAILURE;
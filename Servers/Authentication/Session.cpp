@@ -16,9 +16,10 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include <Authentication/Session.hpp>
+#include <Authentication/SessionManager.hpp>
 #include <Database/AuthDatabase.hpp>
 #include <Realm/RealmList.hpp>
-#include <boost/lexical_cast.hpp>
+#include <Realm/RealmListSnapshot.hpp>
 
 namespace Authentication
 {
@@ -27,6 +28,36 @@ namespace Authentication
 
     Session::Session(boost::asio::ip::tcp::socket socket) : Socket(std::move(socket)) {}
 
+    bool Session::is_idle() { return !m_operation_pending && Socket::is_idle(); }
+
+    template <typename Callback> auto Session::bind_operation(Callback callback)
+    {
+        // Reads stay paused until the completion runs back on the session thread
+        m_operation_pending = true;
+        return bind_to_socket([this, callback = std::move(callback)](auto result) mutable {
+            m_operation_pending = false;
+            callback(std::move(result));
+            if (!m_operation_pending && is_open())
+                on_read();
+        });
+    }
+
+    // The network thread never runs the work itself. When the workers are saturated the caller rejects the client
+    // with a busy result, and reads resume since the dropped completion will never run
+    template <typename Work, typename Callback> bool Session::run_crypto(Work work, Callback callback)
+    {
+        auto task = [work = std::move(work), completion = bind_operation(std::move(callback))]() mutable {
+            completion(work());
+        };
+
+        if (SessionManager::instance()->crypto_workers().enqueue(std::move(task)))
+            return true;
+
+        LOG_DEBUG("Crypto worker queue full, rejecting {}:{}", remote_address().to_string(), remote_port());
+        m_operation_pending = false;
+        return false;
+    }
+
     void Session::on_start()
     {
         LOG_DEBUG("Connected: {}:{}", remote_address().to_string(), remote_port());
@@ -86,6 +117,8 @@ namespace Authentication
             }
 
             buffer.read_completed(size);
+            if (m_operation_pending)
+                return;
         }
 
         async_read();
@@ -101,35 +134,101 @@ namespace Authentication
         m_build = challenge->build;
         m_expansion = calculate_expansion_version(m_build);
 
-        Utilities::ByteBuffer buffer;
-        buffer << std::uint8_t(cmd_auth_logon_challenge);
-        buffer << std::uint8_t(0x00);
-
-        if (!Realm::RealmList::instance()->build_info(m_build))
+        // Only builds with build information get a family, so this is the build information check
+        if (m_expansion == expansion_flag_invalid)
         {
+            Utilities::ByteBuffer buffer;
+            buffer << std::uint8_t(cmd_auth_logon_challenge);
+            buffer << std::uint8_t(0x00);
             buffer << std::uint8_t(login_version_invalid);
-            send_packet(buffer);
+            send_packet(std::move(buffer));
             return true;
         }
 
         auto username =
             std::string(reinterpret_cast<const char *>(challenge->account_name), challenge->account_name_length);
-        auto account_query_sql =
-            fmt::format("SELECT id, username, salt, verifier FROM account WHERE username = '{}';", username);
-        auto account_query = Database::AuthDatabase::instance()->query(account_query_sql.c_str());
-        if (!account_query)
+        AccountCache::Record record;
+        switch (AccountCache::instance()->find(username, record))
         {
-            buffer << std::uint8_t(login_unknown_account);
-            send_packet(buffer);
+        case AccountCache::Lookup::found:
+            logon_challenge_response(&record);
+            return true;
+        case AccountCache::Lookup::unknown:
+            logon_challenge_response(nullptr);
             return true;
+        default:
+            break;
+        }
+
+        Database::PreparedStatement statement(Database::auth_select_account_by_username);
+        statement.set_string(0, username);
+
+        Database::AuthDatabase::instance()->async_query(
+            std::move(statement), bind_operation([this, username = std::move(username)](
+                                                     std::unique_ptr<Database::PreparedResultSet> account_query) {
+                logon_challenge_callback(username, std::move(account_query));
+            }));
+        return true;
+    }
+
+    void Session::logon_challenge_callback(const std::string &username,
+                                           std::unique_ptr<Database::PreparedResultSet> account_query)
+    {
+        auto account_cache = AccountCache::instance();
+        if (!account_query)
+        {
+            account_cache->insert_unknown(username);
+            logon_challenge_response(nullptr);
+            return;
         }
 
         auto fields = account_query->fetch();
-        m_account.load(fields);
+        AccountCache::Record record;
+        record.id = fields[0].get_uint32();
+        record.username = fields[1].get_string();
+        record.salt = fields[2].get_binary<Crypto::Srp6::salt_length>();
+        record.verifier = fields[3].get_binary<Crypto::Srp6::verifier_length>();
+
+        account_cache->insert(username, record);
+        logon_challenge_response(&record);
+    }
+
+    void Session::logon_challenge_response(const AccountCache::Record *record)
+    {
+        if (!record)
+        {
+            Utilities::ByteBuffer buffer;
+            buffer << std::uint8_t(cmd_auth_logon_challenge);
+            buffer << std::uint8_t(0x00);
+            buffer << std::uint8_t(login_unknown_account);
+            send_packet(std::move(buffer));
+            return;
+        }
 
-        m_srp6.emplace(m_account.username, fields[2].get_binary<Crypto::Srp6::salt_length>(),
-                       fields[3].get_binary<Crypto::Srp6::verifier_length>());
+        m_account.load(*record);
+        auto queued = run_crypto(
+            [username = m_account.username, salt = record->salt, verifier = record->verifier]() {
+                return std::make_unique<Crypto::Srp6>(username, salt, verifier);
+            },
+            [this](std::unique_ptr<Crypto::Srp6> srp6) {
+                m_srp6 = std::move(srp6);
+                send_logon_challenge();
+            });
+        if (!queued)
+        {
+            Utilities::ByteBuffer buffer;
+            buffer << std::uint8_t(cmd_auth_logon_challenge);
+            buffer << std::uint8_t(0x00);
+            buffer << std::uint8_t(login_busy);
+            send_packet(std::move(buffer));
+        }
+    }
 
+    void Session::send_logon_challenge()
+    {
+        Utilities::ByteBuffer buffer;
+        buffer << std::uint8_t(cmd_auth_logon_challenge);
+        buffer << std::uint8_t(0x00);
         buffer << std::uint8_t(login_ok);
         buffer.append(m_srp6->B);
         buffer << std::uint8_t(1);
@@ -143,8 +242,7 @@ namespace Authentication
         LOG_DEBUG("Account username = {}, address = {}:{}", m_account.username, remote_address().to_string(),
                   remote_port());
 
-        send_packet(buffer);
-        return true;
+        send_packet(std::move(buffer));
     }
 
     bool Session::logon_proof_handler()
@@ -155,24 +253,51 @@ namespace Authentication
             return false;
         }
 
-        auto logon_proof = reinterpret_cast<cmd_auth_logon_proof_client_t *>(read_buffer().read_ptr());
-        if (auto key = m_srp6->verify_challenge(logon_proof->client_public_key, logon_proof->client_proof))
+        if (!m_srp6)
+        {
+            LOG_DEBUG("Logon proof received without a challenge");
+            return false;
+        }
+
+        auto logon_proof = *reinterpret_cast<cmd_auth_logon_proof_client_t *>(read_buffer().read_ptr());
+        auto queued = run_crypto(
+            [srp6 = m_srp6.get(), logon_proof]() {
+                return srp6->verify_challenge(logon_proof.client_public_key, logon_proof.client_proof);
+            },
+            [this, logon_proof](std::optional<Crypto::Srp6::SessionKey> key) {
+                logon_proof_callback(logon_proof, key);
+            });
+        if (!queued)
+        {
+            Utilities::ByteBuffer buffer;
+            buffer << std::uint8_t(cmd_auth_logon_proof);
+            buffer << std::uint8_t(login_busy);
+            buffer << std::uint16_t(0x0);
+            send_packet(std::move(buffer));
+        }
+        return true;
+    }
+
+    void Session::logon_proof_callback(const cmd_auth_logon_proof_client_t &logon_proof,
+                                       const std::optional<Crypto::Srp6::SessionKey> &key)
+    {
+        if (key)
         {
             m_session_key = *key;
 
-            auto sent_token = (logon_proof->security_flags & 0x04);
+            auto sent_token = (logon_proof.security_flags & 0x04);
             if (sent_token)
             {
                 Utilities::ByteBuffer buffer;
                 buffer << std::uint8_t(cmd_auth_logon_proof);
                 buffer << std::uint8_t(login_unknown_account);
                 buffer << std::uint16_t(0x0);
-                send_packet(buffer);
-                return true;
+                send_packet(std::move(buffer));
+                return;
             }
 
-            auto server_proof = Crypto::Srp6::session_verifier(logon_proof->client_public_key,
-                                                               logon_proof->client_proof, m_session_key);
+            auto server_proof = Crypto::Srp6::session_verifier(logon_proof.client_public_key,
+                                                               logon_proof.client_proof, m_session_key);
 
             LOG_DEBUG("Successfully logged account username = {}, address = {}:{}", m_account.username,
                       remote_address().to_string(), remote_port());
@@ -203,25 +328,37 @@ namespace Authentication
                 std::memcpy(buffer.data(), &proof, sizeof(proof));
             }
 
-            send_packet(buffer);
+            send_packet(std::move(buffer));
         }
         else
         {
+            // The cached verifier may be stale after a password change, so the next attempt reads the account again
+            AccountCache::instance()->invalidate(m_account.username);
+
             Utilities::ByteBuffer buffer;
             buffer << std::uint8_t(cmd_auth_logon_proof);
             buffer << std::uint8_t(login_unknown_account);
             buffer << std::uint16_t(0);
-            send_packet(buffer);
+            send_packet(std::move(buffer));
         }
-        return true;
     }
 
     bool Session::realmlist_handler()
+    {
+        Database::PreparedStatement statement(Database::auth_select_character_counts);
+        statement.set_uint32(0, m_account.id);
+
+        Database::AuthDatabase::instance()->async_query(
+            std::move(statement), bind_operation([this](std::unique_ptr<Database::PreparedResultSet> query) {
+                realmlist_callback(std::move(query));
+            }));
+        return true;
+    }
+
+    void Session::realmlist_callback(std::unique_ptr<Database::PreparedResultSet> query)
     {
         std::map<std::uint32_t, std::uint8_t> characters;
-        auto character_query =
-            fmt::format("SELECT realm_id, count FROM characters WHERE account_id = '{}'", m_account.id);
-        if (auto query = Database::AuthDatabase::instance()->query(character_query.c_str()))
+        if (query)
         {
             do
             {
@@ -230,108 +367,44 @@ namespace Authentication
             } while (query->next_row());
         }
 
-        Utilities::ByteBuffer realmlist_buffer;
-        std::size_t realmlist_size = 0;
-        auto realm_list = Realm::RealmList::instance();
-        for (const auto &realm_map : realm_list->realms())
-        {
-            const auto &realm = realm_map.second;
-
-            std::uint32_t flags = realm.flags;
-            const auto build_info = realm_list->build_info(realm.build);
-            if (m_build != realm.build)
-            {
-                if (!build_info)
-                    continue;
-                flags |= Realm::realmflag_offline | Realm::realmflag_specifybuild;
-            }
-            if (!build_info)
-                flags &= ~Realm::realmflag_specifybuild;
-
-            auto name = realm.name;
-            if (m_expansion & expansion_flag_pre_bc && flags & Realm::realmflag_specifybuild)
-                name = fmt::format("{} ({}.{}.{})", name, build_info->major, build_info->minor, build_info->revision);
-
-            if (m_expansion & expansion_flag_post_bc)
-            {
-                realmlist_buffer << std::uint8_t(realm.type);
-                realmlist_buffer << std::uint8_t(0x01);
-            }
-            else
-                realmlist_buffer << std::uint32_t(realm.type);
-            realmlist_buffer << std::uint8_t(flags);
-            realmlist_buffer << name;
-            realmlist_buffer << boost::lexical_cast<std::string>(realm.address_for_client(remote_address()));
-            realmlist_buffer << float(realm.population);
-            realmlist_buffer << std::uint8_t(characters[realm.id]);
-            realmlist_buffer << std::uint8_t(realm.category);
-            if (m_expansion & expansion_flag_post_bc)
-                realmlist_buffer << std::uint8_t(realm.id);
-            else
-                realmlist_buffer << std::uint8_t(0x00);
-
-            if (m_expansion & expansion_flag_post_bc && flags & Realm::realmflag_specifybuild)
-            {
-                realmlist_buffer << std::uint8_t(build_info->major);
-                realmlist_buffer << std::uint8_t(build_info->minor);
-                realmlist_buffer << std::uint8_t(build_info->revision);
-                realmlist_buffer << std::uint16_t(build_info->build);
-            }
-
-            realmlist_size++;
-        }
-
-        if (m_expansion & expansion_flag_post_bc)
-        {
-            realmlist_buffer << std::uint8_t(0x10);
-            realmlist_buffer << std::uint8_t(0x00);
-        }
-        else
-        {
-            realmlist_buffer << std::uint8_t(0x00);
-            realmlist_buffer << std::uint8_t(0x02);
-        }
-
-        Utilities::ByteBuffer realmlist_size_buffer;
-        realmlist_size_buffer << std::uint32_t(0x00);
-        if (m_expansion & expansion_flag_post_bc)
-            realmlist_size_buffer << std::uint16_t(realmlist_size);
-        else
-            realmlist_size_buffer << std::uint8_t(realmlist_size);
+        Utilities::ByteBuffer buffer;
+        buffer << std::uint8_t(cmd_realmlist);
+        auto size_position = buffer.wpos();
+        buffer << std::uint16_t(0);
+        buffer << std::uint32_t(0x00);
 
-        Utilities::ByteBuffer header_buffer;
-        header_buffer << std::uint8_t(cmd_realmlist);
-        header_buffer << std::uint16_t(realmlist_buffer.size() + realmlist_size_buffer.size());
-        header_buffer.append(realmlist_size_buffer);
-        header_buffer.append(realmlist_buffer);
-        send_packet(header_buffer);
+        auto family = m_expansion & expansion_flag_post_bc ? Realm::RealmListSnapshot::client_family_post_bc
+                                                           : Realm::RealmListSnapshot::client_family_pre_bc;
+        Realm::RealmList::instance()->snapshot()->write(buffer, family, m_build, remote_address(), characters);
 
-        return true;
+        buffer.put(size_position, std::uint16_t(buffer.size() - size_position - sizeof(std::uint16_t)));
+        send_packet(std::move(buffer));
     }
 
-    void Session::send_packet(Utilities::ByteBuffer &packet)
+    void Session::send_packet(Utilities::ByteBuffer &&packet)
     {
         if (packet.empty())
             return;
 
-        Utilities::MessageBuffer buffer(packet.size());
-        buffer.write(packet.data(), packet.size());
-        queue_packet(std::move(buffer));
+        queue_packet(std::move(packet));
     }
 
-    void Session::Account::load(Database::Field *field)
+    void Session::Account::load(const AccountCache::Record &record)
     {
-        id = field[0].get_uint32();
-        username = field[1].get_string();
+        id = record.id;
+        username = record.username;
     }
 
     std::uint8_t Session::calculate_expansion_version(std::uint32_t build)
     {
-        auto realm_list = Realm::RealmList::instance();
-        if (realm_list->is_pre_bc_client(build))
+        switch (Realm::RealmList::instance()->build_family(build))
+        {
+        case Realm::RealmList::build_family_pre_bc:
             return expansion_flag_pre_bc;
-        if (realm_list->is_post_bc_client(build))
+        case Realm::RealmList::build_family_post_bc:
             return expansion_flag_post_bc;
-        return expansion_flag_invalid;
+        default:
+            return expansion_flag_invalid;
+        }
     }
 } // namespace Authentication
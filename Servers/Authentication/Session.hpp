@@ -17,8 +17,10 @@
  */
 #pragma once
 
+#include <Authentication/AccountCache.hpp>
 #include <Crypto/Srp6.hpp>
 #include <Database/Field.hpp>
+#include <Database/PreparedResultSet.hpp>
 #include <Network/Socket.hpp>
 
 namespace Authentication
@@ -28,6 +30,8 @@ namespace Authentication
     public:
         Session(boost::asio::ip::tcp::socket socket);
 
+        bool is_idle() override;
+
     protected:
         void on_start() override;
         void on_read() override;
@@ -48,6 +52,7 @@ namespace Authentication
         {
             login_ok = 0x00,
             login_unknown_account = 0x04,
+            login_busy = 0x08,
             login_version_invalid = 0x09,
         };
 
@@ -70,7 +75,7 @@ namespace Authentication
             std::uint32_t id{0};
             std::string username;
 
-            void load(Database::Field *field);
+            void load(const AccountCache::Record &record);
         };
 
 #pragma pack(push, 1)
@@ -125,15 +130,25 @@ namespace Authentication
         static_assert(sizeof(cmd_auth_logon_proof_server_pos_t) == (1 + 1 + 20 + 4 + 4 + 2));
 #pragma pack(pop)
         std::uint16_t m_build{0};
-        std::optional<Crypto::Srp6> m_srp6;
+        std::unique_ptr<Crypto::Srp6> m_srp6;
         Crypto::Srp6::SessionKey m_session_key{};
         Account m_account{};
         std::uint8_t m_expansion{expansion_flag_invalid};
+        bool m_operation_pending{false};
 
         bool logon_challenge_handler();
         bool logon_proof_handler();
         bool realmlist_handler();
-        void send_packet(Utilities::ByteBuffer &packet);
+        void logon_challenge_callback(const std::string &username,
+                                      std::unique_ptr<Database::PreparedResultSet> account_query);
+        void logon_challenge_response(const AccountCache::Record *record);
+        void send_logon_challenge();
+        void logon_proof_callback(const cmd_auth_logon_proof_client_t &logon_proof,
+                                  const std::optional<Crypto::Srp6::SessionKey> &key);
+        void realmlist_callback(std::unique_ptr<Database::PreparedResultSet> character_query);
+        template <typename Callback> auto bind_operation(Callback callback);
+        template <typename Work, typename Callback> bool run_crypto(Work work, Callback callback);
+        void send_packet(Utilities::ByteBuffer &&packet);
         std::uint8_t calculate_expansion_version(std::uint32_t build);
     };
 } // namespace Authentication
@@ -15,7 +15,10 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <Authentication/AccountCache.hpp>
 #include <Authentication/SessionManager.hpp>
+#include <Utilities/Log.hpp>
+#include <algorithm>
 
 namespace Authentication
 {
@@ -28,11 +31,17 @@ namespace Authentication
         return m_instance;
     }
 
-    bool SessionManager::init(boost::asio::io_context &io_context, const std::string &ip, int port, int thread_count)
+    bool SessionManager::init(boost::asio::io_context &io_context, const std::string &ip, int port, int thread_count,
+                              const Network::AcceptorOptions &options)
     {
-        if (!Network::SocketManager<Session>::init(io_context, ip, port, thread_count))
+        if (!Network::SocketManager<Session>::init(io_context, ip, port, thread_count, options))
             return false;
-        m_acceptor->async_accept_with_callback<&SessionManager::on_socket_accept>();
+
+        auto crypto_threads = std::max(1u, std::thread::hardware_concurrency());
+        m_crypto_workers = std::make_unique<Thread::WorkerPool>(crypto_threads, crypto_queue_capacity);
+        LOG_DEBUG("Started {} crypto worker threads", crypto_threads);
+
+        start_accept<&SessionManager::on_socket_accept>();
         return true;
     }
 
@@ -41,5 +50,17 @@ namespace Authentication
         instance()->on_socket_open(std::forward<boost::asio::ip::tcp::socket>(socket), index);
     }
 
-    Network::Thread<Session> *SessionManager::create_threads() const { return new Network::Thread<Session>[1]; }
+    void SessionManager::log_statistics()
+    {
+        auto cache = AccountCache::instance()->statistics();
+        LOG_TRACE("Account cache, size = {}, hit rate = {:.3f}, hits = {}, negative hits = {}, misses = {}, "
+                  "evictions = {}, expirations = {}, invalidations = {}",
+                  cache.size, cache.hit_rate(), cache.hits, cache.negative_hits, cache.misses, cache.evictions,
+                  cache.expirations, cache.invalidations);
+    }
+
+    Network::Thread<Session> *SessionManager::create_threads() const
+    {
+        return new Network::Thread<Session>[thread_count()];
+    }
 } // namespace Authentication
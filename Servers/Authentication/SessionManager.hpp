@@ -19,6 +19,8 @@
 
 #include <Authentication/Session.hpp>
 #include <Network/SocketManager.hpp>
+#include <Thread/WorkerPool.hpp>
+#include <memory>
 
 namespace Authentication
 {
@@ -27,14 +29,21 @@ namespace Authentication
     public:
         static SessionManager *instance();
 
-        bool init(boost::asio::io_context &io_context, const std::string &ip, int port, int thread_count) override;
+        bool init(boost::asio::io_context &io_context, const std::string &ip, int port, int thread_count,
+                  const Network::AcceptorOptions &options = {}) override;
+
+        Thread::WorkerPool &crypto_workers() { return *m_crypto_workers; }
 
     protected:
         [[nodiscard]] Network::Thread<Session> *create_threads() const override;
+        void log_statistics() override;
 
     private:
+        static constexpr std::size_t crypto_queue_capacity = 1024;
         static SessionManager *m_instance;
 
+        std::unique_ptr<Thread::WorkerPool> m_crypto_workers;
+
         static void on_socket_accept(boost::asio::ip::tcp::socket &&socket, std::uint32_t index);
     };
 } // namespace Authentication
@@ -16,7 +16,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include <Database/AuthDatabase.hpp>
+#include <Database/WriteBehindQueue.hpp>
 #include <Realm/Realm.hpp>
+#include <Realm/RealmStatus.hpp>
 #include <Utilities/Log.hpp>
 #include <World/Session.hpp>
 #include <boost/asio/co_spawn.hpp>
@@ -53,24 +55,41 @@ int main()
         Utilities::Log::init();
 
         auto auth_database = Database::AuthDatabase::instance();
-        auth_database->open();
+        Database::WriteBehindQueue realm_writes(*auth_database);
+        auto realm_flags = realm_writes.register_batch({"realmlist", {"id"}, {{"flags", "(flags | ?) & ~?"}}});
+        if (!realm_flags)
+        {
+            LOG_ERROR("Failed to register realm flag writes");
+            return EXIT_FAILURE;
+        }
 
-        auth_database->execute(
-            fmt::format("UPDATE realmlist SET flags = flags | {} WHERE id = {}", Realm::realmflag_offline, 1).c_str());
+        auth_database->open();
 
         boost::asio::io_context io_context(1);
 
+        Realm::RealmStatusSender realm_status(io_context);
+        auto set_realm_offline = [&](bool offline) {
+            auto flag = std::uint8_t(Realm::realmflag_offline);
+            auto set_flags = offline ? flag : std::uint8_t(0);
+            auto clear_flags = offline ? std::uint8_t(0) : flag;
+            realm_writes.update(*realm_flags, {1}, {set_flags, clear_flags});
+            realm_status.send({1, set_flags, clear_flags, 0, 0.0f});
+        };
+
+        set_realm_offline(true);
+
         boost::asio::co_spawn(io_context,
                               listener(boost::asio::ip::tcp::acceptor(io_context, {boost::asio::ip::tcp::v4(), 8085})),
                               boost::asio::detached);
         boost::asio::signal_set signals(io_context, SIGINT, SIGTERM);
         signals.async_wait([&](auto, auto) { io_context.stop(); });
 
-        auth_database->execute(
-            fmt::format("UPDATE realmlist SET flags = flags & ~{} WHERE id = {}", Realm::realmflag_offline, 1).c_str());
+        set_realm_offline(false);
 
         io_context.run();
 
+        set_realm_offline(true);
+        realm_writes.stop();
         auth_database->close();
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000L
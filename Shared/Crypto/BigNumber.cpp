@@ -19,6 +19,8 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <memory>
+#include <utility>
 
 namespace Crypto
 {
@@ -26,6 +28,9 @@ namespace Crypto
 
     BigNumber::BigNumber(const BigNumber &bn) : m_bn(BN_dup(bn.bn())) {}
 
+    // Moving never allocates, the source is left without a number and can only be assigned to or destroyed
+    BigNumber::BigNumber(BigNumber &&bn) noexcept : m_bn(std::exchange(bn.m_bn, nullptr)) {}
+
     BigNumber::BigNumber(std::int32_t value) : BigNumber() { set_dword(value); }
 
     BigNumber::BigNumber(std::uint32_t value) : BigNumber() { set_dword(value); }
@@ -84,21 +89,52 @@ namespace Crypto
 
     std::int32_t BigNumber::number_of_bytes() const { return BN_num_bytes(m_bn); }
 
+    BN_CTX *BigNumber::context()
+    {
+        static thread_local std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)> context(BN_CTX_new(), &BN_CTX_free);
+        return context.get();
+    }
+
     BigNumber BigNumber::mod_exp(const BigNumber &bn1, const BigNumber &bn2) const
     {
         BigNumber result;
-        BN_CTX *context = BN_CTX_new();
-        BN_mod_exp(result.m_bn, m_bn, bn1.m_bn, bn2.m_bn, context);
-        BN_CTX_free(context);
+        BN_mod_exp(result.m_bn, m_bn, bn1.m_bn, bn2.m_bn, context());
         return result;
     }
 
+    BigNumber &BigNumber::mod_add(const BigNumber &bn, const BigNumber &modulus)
+    {
+        BN_mod_add(m_bn, m_bn, bn.m_bn, modulus.m_bn, context());
+        return *this;
+    }
+
+    BigNumber &BigNumber::mod_sub(const BigNumber &bn, const BigNumber &modulus)
+    {
+        BN_mod_sub(m_bn, m_bn, bn.m_bn, modulus.m_bn, context());
+        return *this;
+    }
+
+    BigNumber &BigNumber::mod_mul(const BigNumber &bn, const BigNumber &modulus)
+    {
+        BN_mod_mul(m_bn, m_bn, bn.m_bn, modulus.m_bn, context());
+        return *this;
+    }
+
     BigNumber &BigNumber::operator=(const BigNumber &bn)
     {
         if (this == &bn)
             return *this;
 
-        BN_copy(m_bn, bn.m_bn);
+        if (!m_bn)
+            m_bn = BN_dup(bn.m_bn);
+        else
+            BN_copy(m_bn, bn.m_bn);
+        return *this;
+    }
+
+    BigNumber &BigNumber::operator=(BigNumber &&bn) noexcept
+    {
+        std::swap(m_bn, bn.m_bn);
         return *this;
     }
 
@@ -111,7 +147,8 @@ namespace Crypto
     BigNumber BigNumber::operator+(const BigNumber &bn) const
     {
         BigNumber result(*this);
-        return result += bn;
+        result += bn;
+        return result;
     }
 
     BigNumber &BigNumber::operator-=(const BigNumber &bn)
@@ -123,49 +160,47 @@ namespace Crypto
     BigNumber BigNumber::operator-(const BigNumber &bn) const
     {
         BigNumber result(*this);
-        return result -= bn;
+        result -= bn;
+        return result;
     }
 
     BigNumber &BigNumber::operator*=(const BigNumber &bn)
     {
-        BN_CTX *context = BN_CTX_new();
-        BN_mul(m_bn, m_bn, bn.m_bn, context);
-        BN_CTX_free(context);
+        BN_mul(m_bn, m_bn, bn.m_bn, context());
         return *this;
     }
 
     BigNumber BigNumber::operator*(const BigNumber &bn) const
     {
         BigNumber result(*this);
-        return result *= bn;
+        result *= bn;
+        return result;
     }
 
     BigNumber &BigNumber::operator/=(const BigNumber &bn)
     {
-        BN_CTX *bnctx = BN_CTX_new();
-        BN_div(m_bn, nullptr, m_bn, bn.m_bn, bnctx);
-        BN_CTX_free(bnctx);
+        BN_div(m_bn, nullptr, m_bn, bn.m_bn, context());
         return *this;
     }
 
     BigNumber BigNumber::operator/(const BigNumber &bn) const
     {
         BigNumber result(*this);
-        return result /= bn;
+        result /= bn;
+        return result;
     }
 
     BigNumber &BigNumber::operator%=(const BigNumber &bn)
     {
-        BN_CTX *context = BN_CTX_new();
-        BN_mod(m_bn, m_bn, bn.m_bn, context);
-        BN_CTX_free(context);
+        BN_mod(m_bn, m_bn, bn.m_bn, context());
         return *this;
     }
 
     BigNumber BigNumber::operator%(const BigNumber &bn) const
     {
         BigNumber result(*this);
-        return result %= bn;
+        result %= bn;
+        return result;
     }
 
     BigNumber &BigNumber::operator<<=(int number)
@@ -177,7 +212,8 @@ namespace Crypto
     BigNumber BigNumber::operator<<(int number) const
     {
         BigNumber result(*this);
-        return result <<= number;
+        result <<= number;
+        return result;
     }
 
     bool BigNumber::is_zero() const { return BN_is_zero(m_bn); }
@@ -28,6 +28,7 @@ namespace Crypto
     public:
         BigNumber();
         BigNumber(const BigNumber &bn);
+        BigNumber(BigNumber &&bn) noexcept;
         BigNumber(std::int32_t value);
         BigNumber(std::uint32_t value);
         template <std::size_t Size>
@@ -40,7 +41,14 @@ namespace Crypto
         auto bn() { return m_bn; }
         const auto bn() const { return m_bn; }
 
+        // Scratch context reused by every operation of the calling thread
+        static BN_CTX *context();
+
         BigNumber mod_exp(const BigNumber &bn1, const BigNumber &bn2) const;
+        // In place modular arithmetic, this = (this op bn) % modulus without any temporary
+        BigNumber &mod_add(const BigNumber &bn, const BigNumber &modulus);
+        BigNumber &mod_sub(const BigNumber &bn, const BigNumber &modulus);
+        BigNumber &mod_mul(const BigNumber &bn, const BigNumber &modulus);
 
         template <std::size_t Size> std::array<std::uint8_t, Size> to_byte_array(bool little_endian = true) const
         {
@@ -52,6 +60,7 @@ namespace Crypto
         bool is_zero() const;
 
         BigNumber &operator=(BigNumber const &bn);
+        BigNumber &operator=(BigNumber &&bn) noexcept;
         BigNumber &operator+=(const BigNumber &bn);
         BigNumber operator+(const BigNumber &bn) const;
         BigNumber &operator-=(const BigNumber &bn);
@@ -66,6 +75,10 @@ namespace Crypto
         BigNumber operator<<(int number) const;
 
     private:
+        // Stores its table as raw little-endian words, through the byte helpers that cover older OpenSSL
+        friend class FixedBaseTable;
+
+        // Null only once moved from
         bignum_st *m_bn;
 
         void set_binary(const std::uint8_t *bytes, std::int32_t length, bool little_endian = true);
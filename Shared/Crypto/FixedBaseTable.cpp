@@ -0,0 +1,105 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Crypto/FixedBaseTable.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace Crypto
+{
+    FixedBaseTable::FixedBaseTable(const BigNumber &base, const MontgomeryContext &context, std::size_t exponent_bits)
+        : m_context(context), m_base(base), m_windows((exponent_bits + window_bits - 1) / window_bits),
+          m_words((BN_num_bytes(context.modulus().bn()) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t))
+    {
+        assert(m_words <= max_words);
+
+        // Window i holds base^(j * 2^(window_bits * i)) for every digit j, kept in Montgomery form as little-endian
+        // bytes padded to whole 64-bit words so the selection below can work a word at a time
+        m_table.resize(m_windows * window_entries * m_words);
+
+        auto mont = m_context.get();
+        auto bn_context = BigNumber::context();
+        BigNumber window_base;
+        BigNumber entry;
+        BN_to_montgomery(window_base.bn(), m_base.bn(), mont, bn_context);
+
+        for (std::size_t window = 0; window < m_windows; window++)
+        {
+            BN_to_montgomery(entry.bn(), BigNumber(1u).bn(), mont, bn_context);
+            for (std::size_t digit = 0; digit < window_entries; digit++)
+            {
+                auto output = &m_table[(window * window_entries + digit) * m_words];
+                entry.get_bytes(reinterpret_cast<std::uint8_t *>(output), width(), true);
+                BN_mod_mul_montgomery(entry.bn(), entry.bn(), window_base.bn(), mont, bn_context);
+            }
+            window_base = entry;
+        }
+    }
+
+    BigNumber FixedBaseTable::mod_exp(const BigNumber &exponent) const
+    {
+        if (BN_is_negative(exponent.bn()) || std::size_t(BN_num_bits(exponent.bn())) > m_windows * window_bits)
+            return m_context.mod_exp(m_base, exponent);
+
+        auto mont = m_context.get();
+        auto bn_context = BigNumber::context();
+        std::uint64_t selected[max_words];
+        auto selected_bytes = reinterpret_cast<const std::uint8_t *>(selected);
+        BigNumber accumulator;
+        BigNumber factor;
+
+        for (std::size_t window = 0; window < m_windows; window++)
+        {
+            std::size_t digit = 0;
+            for (std::size_t bit = 0; bit < window_bits; bit++)
+                digit |= std::size_t(BN_is_bit_set(exponent.bn(), int(window * window_bits + bit))) << bit;
+
+            // BigNumber converts the little-endian entries itself where OpenSSL predates BN_lebin2bn
+            select(window, digit, selected);
+            if (!window)
+            {
+                accumulator.set_binary(selected_bytes, std::int32_t(width()));
+                continue;
+            }
+
+            factor.set_binary(selected_bytes, std::int32_t(width()));
+            BN_mod_mul_montgomery(accumulator.bn(), accumulator.bn(), factor.bn(), mont, bn_context);
+        }
+
+        BN_from_montgomery(accumulator.bn(), accumulator.bn(), mont, bn_context);
+        return accumulator;
+    }
+
+    void FixedBaseTable::select(std::size_t window, std::size_t digit, std::uint64_t *output) const
+    {
+        // The exponent is secret, so every entry of the window is read and the match is kept through a mask
+        std::fill_n(output, m_words, 0);
+        auto entries = &m_table[window * window_entries * m_words];
+        for (std::size_t j = 0; j < window_entries; j++)
+        {
+            auto mask = std::uint64_t(0) - std::uint64_t(((j ^ digit) - 1) >> (sizeof(std::size_t) * 8 - 1));
+            auto entry = entries + j * m_words;
+            for (std::size_t i = 0; i < m_words; i++)
+                output[i] |= entry[i] & mask;
+        }
+    }
+
+    std::size_t FixedBaseTable::width() const
+    {
+        return m_words * sizeof(std::uint64_t);
+    }
+} // namespace Crypto
@@ -0,0 +1,49 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Crypto/BigNumber.hpp>
+#include <Crypto/MontgomeryContext.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Crypto
+{
+    class FixedBaseTable
+    {
+    public:
+        FixedBaseTable(const BigNumber &base, const MontgomeryContext &context, std::size_t exponent_bits);
+
+        BigNumber mod_exp(const BigNumber &exponent) const;
+
+    private:
+        static constexpr std::size_t window_bits = 4;
+        static constexpr std::size_t window_entries = std::size_t(1) << window_bits;
+        // Moduli up to 512 bits, which keeps the selected entry on the stack
+        static constexpr std::size_t max_words = 8;
+
+        const MontgomeryContext &m_context;
+        BigNumber m_base;
+        std::size_t m_windows;
+        std::size_t m_words;
+        std::vector<std::uint64_t> m_table;
+
+        void select(std::size_t window, std::size_t digit, std::uint64_t *output) const;
+        std::size_t width() const;
+    };
+} // namespace Crypto
@@ -19,6 +19,7 @@
 
 #include <array>
 #include <cassert>
+#include <memory>
 #include <openssl/evp.h>
 #include <string>
 #include <utility>
@@ -47,11 +48,7 @@ namespace Crypto
         static constexpr size_t disgest_length = DigestLength;
         using Digest = std::array<std::uint8_t, disgest_length>;
 
-        GenericHash() : m_context(Details::GenericHash::make_context())
-        {
-            auto result = EVP_DigestInit_ex(m_context, HashCreator(), nullptr);
-            assert(result == 1);
-        }
+        GenericHash() : GenericHash(Details::GenericHash::make_context(), true) {}
 
         GenericHash(const GenericHash &right) : m_context(Details::GenericHash::make_context()) { *this = right; }
 
@@ -59,7 +56,7 @@ namespace Crypto
 
         ~GenericHash()
         {
-            if (!m_context)
+            if (!m_context || !m_owned)
                 return;
             Details::GenericHash::destroy_context(m_context);
             m_context = nullptr;
@@ -70,7 +67,7 @@ namespace Crypto
         template <typename... T>
         static auto digest_of(T &&...pack) -> std::enable_if_t<!(std::is_integral_v<std::decay_t<T>> || ...), Digest>
         {
-            GenericHash hash;
+            GenericHash hash(thread_context(), false);
             (hash.update_data(std::forward<T>(pack)), ...);
             hash.finalize();
             return hash.digest();
@@ -78,7 +75,7 @@ namespace Crypto
 
         static Digest digest_of(const std::uint8_t *data, std::size_t length)
         {
-            GenericHash hash;
+            GenericHash hash(thread_context(), false);
             hash.update_data(data, length);
             hash.finalize();
             return hash.digest();
@@ -101,14 +98,42 @@ namespace Crypto
                 return *this;
 
             m_context = std::exchange(right.m_context, Details::GenericHash::make_context());
+            m_owned = std::exchange(right.m_owned, true);
             m_digest = std::exchange(right.m_digest, Digest{});
             return *this;
         }
 
     private:
         EVP_MD_CTX *m_context;
+        bool m_owned{true};
         Digest m_digest{};
 
+        GenericHash(EVP_MD_CTX *context, bool owned) : m_context(context), m_owned(owned)
+        {
+            auto result = EVP_DigestInit_ex(m_context, algorithm(), nullptr);
+            assert(result == 1);
+        }
+
+        static const EVP_MD *algorithm()
+        {
+#if defined(OPENSSL_VERSION_NUMBER) && OPENSSL_VERSION_NUMBER >= 0x30000000L
+            // The legacy getters make every EVP_DigestInit_ex look the provider implementation up again
+            static const std::unique_ptr<EVP_MD, decltype(&EVP_MD_free)> algorithm(
+                EVP_MD_fetch(nullptr, EVP_MD_get0_name(HashCreator()), nullptr), &EVP_MD_free);
+            return algorithm.get();
+#else
+            return HashCreator();
+#endif
+        }
+
+        // One-shot digests of a thread share a context, which only needs to be initialised again per message
+        static EVP_MD_CTX *thread_context()
+        {
+            static thread_local std::unique_ptr<EVP_MD_CTX, decltype(&Details::GenericHash::destroy_context)> context(
+                Details::GenericHash::make_context(), &Details::GenericHash::destroy_context);
+            return context.get();
+        }
+
         void update_data(const std::uint8_t *data, std::size_t length)
         {
             auto result = EVP_DigestUpdate(m_context, data, length);
@@ -0,0 +1,219 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Crypto/Montgomery256.hpp>
+#include <cassert>
+
+#if !defined(__SIZEOF_INT128__)
+#error "Montgomery256 needs a compiler with unsigned __int128"
+#endif
+
+namespace Crypto
+{
+    namespace Details
+    {
+        using uint128_t = unsigned __int128;
+
+        inline std::uint64_t add_carry(std::uint64_t a, std::uint64_t b, std::uint64_t &carry)
+        {
+            auto result = uint128_t(a) + b + carry;
+            carry = std::uint64_t(result >> 64);
+            return std::uint64_t(result);
+        }
+
+        inline std::uint64_t sub_borrow(std::uint64_t a, std::uint64_t b, std::uint64_t &borrow)
+        {
+            auto result = uint128_t(a) - b - borrow;
+            borrow = std::uint64_t(result >> 64) & 1;
+            return std::uint64_t(result);
+        }
+
+        // Three word column sum used by product scanning
+        class Accumulator
+        {
+        public:
+            void add(std::uint64_t a, std::uint64_t b)
+            {
+                auto product = uint128_t(a) * b;
+                auto sum = m_low + product;
+                m_high += sum < product;
+                m_low = sum;
+            }
+
+            std::uint64_t low() const { return std::uint64_t(m_low); }
+
+            void shift()
+            {
+                m_low = (m_low >> 64) | (uint128_t(m_high) << 64);
+                m_high = 0;
+            }
+
+        private:
+            uint128_t m_low = 0;
+            std::uint64_t m_high = 0;
+        };
+    } // namespace Details
+
+    Montgomery256::Montgomery256(const Uint256 &modulus) : m_modulus(modulus)
+    {
+        auto &n = m_modulus.limbs();
+        assert(n[0] & 1);
+
+        // Newton iteration doubles the correct low bits of N^-1 mod 2^64 on every step
+        std::uint64_t inverse = 1;
+        for (int i = 0; i < 6; i++)
+            inverse *= 2 - n[0] * inverse;
+        m_inverse = 0 - inverse;
+
+        // R^2 mod N with R = 2^256, reached by doubling 1 five hundred and twelve times
+        Uint256 r2(1);
+        for (int i = 0; i < 512; i++)
+            r2 = add(r2, r2);
+        m_r2 = r2;
+        m_one = to_montgomery(Uint256(1));
+    }
+
+    Uint256 Montgomery256::to_montgomery(const Uint256 &value) const { return multiply(value, m_r2); }
+
+    Uint256 Montgomery256::from_montgomery(const Uint256 &value) const { return multiply(value, Uint256(1)); }
+
+    Uint256 Montgomery256::multiply(const Uint256 &a, const Uint256 &b) const
+    {
+        // Finely integrated product scanning: column k of a * b and of m * N is summed into a three word accumulator,
+        // the low columns pick the Montgomery factors m that clear them and the high columns are the result
+        constexpr auto limbs = Uint256::limb_count;
+        auto &x = a.limbs();
+        auto &y = b.limbs();
+        auto &n = m_modulus.limbs();
+        std::uint64_t m[limbs];
+        Details::Accumulator accumulator;
+
+        for (std::size_t i = 0; i < limbs; i++)
+        {
+            for (std::size_t j = 0; j < i; j++)
+            {
+                accumulator.add(x[j], y[i - j]);
+                accumulator.add(m[j], n[i - j]);
+            }
+            accumulator.add(x[i], y[0]);
+            m[i] = accumulator.low() * m_inverse;
+            accumulator.add(m[i], n[0]);
+            accumulator.shift();
+        }
+
+        Uint256 result;
+        for (std::size_t i = limbs; i < 2 * limbs - 1; i++)
+        {
+            for (std::size_t j = i - limbs + 1; j < limbs; j++)
+            {
+                accumulator.add(x[j], y[i - j]);
+                accumulator.add(m[j], n[i - j]);
+            }
+            result.limbs()[i - limbs] = accumulator.low();
+            accumulator.shift();
+        }
+        result.limbs()[limbs - 1] = accumulator.low();
+        accumulator.shift();
+        return reduce(result, accumulator.low());
+    }
+
+    Uint256 Montgomery256::add(const Uint256 &a, const Uint256 &b) const
+    {
+        Uint256 result;
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < Uint256::limb_count; i++)
+            result.limbs()[i] = Details::add_carry(a.limbs()[i], b.limbs()[i], carry);
+        return reduce(result, carry);
+    }
+
+    Uint256 Montgomery256::mod_exp(const Uint256 &base, const Uint256 &exponent, std::size_t exponent_bits) const
+    {
+        assert(exponent_bits <= windows * window_bits);
+
+        Uint256 table[window_entries];
+        table[0] = m_one;
+        for (std::size_t i = 1; i < window_entries; i++)
+            table[i] = multiply(table[i - 1], base);
+
+        auto result = m_one;
+        for (std::size_t window = (exponent_bits + window_bits - 1) / window_bits; window-- > 0;)
+        {
+            for (std::size_t i = 0; i < window_bits; i++)
+                result = multiply(result, result);
+            result = multiply(result, select(table, digit(exponent, window)));
+        }
+        return result;
+    }
+
+    std::size_t Montgomery256::digit(const Uint256 &exponent, std::size_t window)
+    {
+        constexpr auto windows_per_limb = 64 / window_bits;
+        auto limb = exponent.limbs()[window / windows_per_limb];
+        return std::size_t(limb >> (window_bits * (window % windows_per_limb))) & (window_entries - 1);
+    }
+
+    Uint256 Montgomery256::select(const Uint256 *entries, std::size_t index)
+    {
+        // Every entry is read and the wanted one is kept through a mask, so the index does not show in memory access
+        Uint256 result;
+        for (std::size_t j = 0; j < window_entries; j++)
+        {
+            auto mask = std::uint64_t(0) - std::uint64_t(((j ^ index) - 1) >> (sizeof(std::size_t) * 8 - 1));
+            for (std::size_t i = 0; i < Uint256::limb_count; i++)
+                result.limbs()[i] |= entries[j].limbs()[i] & mask;
+        }
+        return result;
+    }
+
+    Uint256 Montgomery256::reduce(const Uint256 &value, std::uint64_t carry) const
+    {
+        // value + carry * 2^256 is below 2N, so a single masked subtraction brings it under N
+        Uint256 difference;
+        std::uint64_t borrow = 0;
+        for (std::size_t i = 0; i < Uint256::limb_count; i++)
+            difference.limbs()[i] = Details::sub_borrow(value.limbs()[i], m_modulus.limbs()[i], borrow);
+
+        auto mask = std::uint64_t(0) - (carry | (borrow ^ 1));
+        Uint256 result;
+        for (std::size_t i = 0; i < Uint256::limb_count; i++)
+            result.limbs()[i] = (difference.limbs()[i] & mask) | (value.limbs()[i] & ~mask);
+        return result;
+    }
+
+    Montgomery256::FixedBaseTable::FixedBaseTable(const Montgomery256 &field, const Uint256 &base)
+        : m_field(field), m_table(windows * window_entries)
+    {
+        // Window i holds base^(j * 2^(window_bits * i)) for every digit j
+        auto window_base = base;
+        for (std::size_t window = 0; window < windows; window++)
+        {
+            auto entries = &m_table[window * window_entries];
+            entries[0] = m_field.one();
+            for (std::size_t j = 1; j < window_entries; j++)
+                entries[j] = m_field.multiply(entries[j - 1], window_base);
+            window_base = m_field.multiply(entries[window_entries - 1], window_base);
+        }
+    }
+
+    Uint256 Montgomery256::FixedBaseTable::mod_exp(const Uint256 &exponent) const
+    {
+        auto result = m_field.one();
+        for (std::size_t window = 0; window < windows; window++)
+            result = m_field.multiply(result, select(&m_table[window * window_entries], digit(exponent, window)));
+        return result;
+    }
+} // namespace Crypto
@@ -0,0 +1,73 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Crypto/Uint256.hpp>
+#include <vector>
+
+namespace Crypto
+{
+    // Montgomery arithmetic modulo an odd 256-bit N on stack allocated limbs. Every operation runs in time independent
+    // of its operands, values passed in and out are in Montgomery form unless stated otherwise
+    class Montgomery256
+    {
+    public:
+        class FixedBaseTable
+        {
+        public:
+            FixedBaseTable(const Montgomery256 &field, const Uint256 &base);
+
+            Uint256 mod_exp(const Uint256 &exponent) const;
+
+        private:
+            const Montgomery256 &m_field;
+            std::vector<Uint256> m_table;
+        };
+
+        explicit Montgomery256(const Uint256 &modulus);
+        Montgomery256(const Montgomery256 &) = delete;
+        Montgomery256 &operator=(const Montgomery256 &) = delete;
+
+        const auto &modulus() const { return m_modulus; }
+        const auto &one() const { return m_one; }
+
+        // Accepts any 256-bit value, including ones not reduced modulo N
+        Uint256 to_montgomery(const Uint256 &value) const;
+        // Returns the reduced plain value
+        Uint256 from_montgomery(const Uint256 &value) const;
+
+        Uint256 multiply(const Uint256 &a, const Uint256 &b) const;
+        Uint256 add(const Uint256 &a, const Uint256 &b) const;
+        // The exponent is a plain value whose low exponent_bits are all processed, whatever their value
+        Uint256 mod_exp(const Uint256 &base, const Uint256 &exponent, std::size_t exponent_bits = 256) const;
+
+    private:
+        static constexpr std::size_t window_bits = 4;
+        static constexpr std::size_t window_entries = std::size_t(1) << window_bits;
+        static constexpr std::size_t windows = Uint256::byte_count * 8 / window_bits;
+
+        Uint256 m_modulus;
+        std::uint64_t m_inverse;
+        Uint256 m_r2;
+        Uint256 m_one;
+
+        static std::size_t digit(const Uint256 &exponent, std::size_t window);
+        static Uint256 select(const Uint256 *entries, std::size_t index);
+        Uint256 reduce(const Uint256 &value, std::uint64_t carry) const;
+    };
+} // namespace Crypto
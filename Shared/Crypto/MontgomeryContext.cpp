@@ -0,0 +1,37 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Crypto/MontgomeryContext.hpp>
+#include <cassert>
+
+namespace Crypto
+{
+    MontgomeryContext::MontgomeryContext(const BigNumber &modulus) : m_modulus(modulus), m_context(BN_MONT_CTX_new())
+    {
+        auto result = BN_MONT_CTX_set(m_context, m_modulus.bn(), BigNumber::context());
+        assert(result == 1);
+    }
+
+    MontgomeryContext::~MontgomeryContext() { BN_MONT_CTX_free(m_context); }
+
+    BigNumber MontgomeryContext::mod_exp(const BigNumber &base, const BigNumber &exponent) const
+    {
+        BigNumber result;
+        BN_mod_exp_mont(result.bn(), base.bn(), exponent.bn(), m_modulus.bn(), BigNumber::context(), m_context);
+        return result;
+    }
+} // namespace Crypto
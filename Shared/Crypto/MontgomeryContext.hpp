@@ -0,0 +1,43 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Crypto/BigNumber.hpp>
+#include <openssl/bn.h>
+
+namespace Crypto
+{
+    class MontgomeryContext
+    {
+    public:
+        explicit MontgomeryContext(const BigNumber &modulus);
+        MontgomeryContext(const MontgomeryContext &) = delete;
+        MontgomeryContext &operator=(const MontgomeryContext &) = delete;
+        ~MontgomeryContext();
+
+        const auto &modulus() const { return m_modulus; }
+        // OpenSSL takes the context as non const even though it only reads it
+        auto get() const { return m_context; }
+
+        BigNumber mod_exp(const BigNumber &base, const BigNumber &exponent) const;
+
+    private:
+        BigNumber m_modulus;
+        BN_MONT_CTX *m_context;
+    };
+} // namespace Crypto
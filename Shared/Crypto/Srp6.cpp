@@ -65,18 +65,79 @@ namespace Crypto
     const std::array<std::uint8_t, 1> Srp6::g = {7};
     const std::array<std::uint8_t, 32> Srp6::N =
         hex_string_to_byte_array<32>("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7", true);
+#if !defined(CRYPTO_NATIVE_SRP6)
     const BigNumber Srp6::m_g(Srp6::g);
     const BigNumber Srp6::m_N(Srp6::N);
+    const BigNumber Srp6::m_k(3u);
+#endif
 
     Srp6::Srp6(const std::string &username, const Salt &salt, const Verifier &verifier)
         : m_I(SHA1::digest_of(username)), m_b(get_random_bytes<32>()), m_v(verifier), s(salt), B(calculate_B(m_b, m_v))
     {
     }
 
+    void Srp6::init()
+    {
+        ng_hash();
+        g_table();
+    }
+
+    const SHA1::Digest &Srp6::ng_hash()
+    {
+        static const SHA1::Digest hash = [] {
+            const SHA1::Digest n_hash = SHA1::digest_of(N);
+            const SHA1::Digest g_hash = SHA1::digest_of(g);
+
+            SHA1::Digest result;
+            std::transform(n_hash.begin(), n_hash.end(), g_hash.begin(), result.begin(), std::bit_xor<>());
+            return result;
+        }();
+        return hash;
+    }
+
+#if defined(CRYPTO_NATIVE_SRP6)
+    const Montgomery256 &Srp6::montgomery()
+    {
+        static const Montgomery256 field{Uint256(N)};
+        return field;
+    }
+
+    const Montgomery256::FixedBaseTable &Srp6::g_table()
+    {
+        static const Montgomery256::FixedBaseTable table(montgomery(), montgomery().to_montgomery(Uint256(g)));
+        return table;
+    }
+
+    Srp6::EphemeralKey Srp6::calculate_B(const Uint256 &b, const Uint256 &v)
+    {
+        // B = (g^b + k * v) % N with k = 3
+        auto &field = montgomery();
+        auto kv = field.multiply(field.to_montgomery(Uint256(3)), field.to_montgomery(v));
+        return field.from_montgomery(field.add(g_table().mod_exp(b), kv)).to_byte_array<ephemeral_key_length>();
+    }
+#else
+    const MontgomeryContext &Srp6::montgomery()
+    {
+        static const MontgomeryContext context(m_N);
+        return context;
+    }
+
+    const FixedBaseTable &Srp6::g_table()
+    {
+        // b is drawn from 32 random bytes, so 256 exponent bits always hit the table
+        static const FixedBaseTable table(m_g, montgomery(), 8 * 32);
+        return table;
+    }
+
     Srp6::EphemeralKey Srp6::calculate_B(const BigNumber &b, const BigNumber &v)
     {
-        return ((m_g.mod_exp(b, m_N) + (v * 3)) % N).to_byte_array<ephemeral_key_length>();
+        // B = (g^b + k * v) % N with k = 3
+        auto B = g_table().mod_exp(b);
+        BigNumber kv(v);
+        kv.mod_mul(m_k, m_N);
+        return B.mod_add(kv, m_N).to_byte_array<ephemeral_key_length>();
     }
+#endif
 
     SHA1::Digest Srp6::session_verifier(const EphemeralKey &p_a, const SHA1::Digest &p_m, const SessionKey &key)
     {
@@ -88,20 +149,32 @@ namespace Crypto
         assert(!m_used);
         m_used = true;
 
-        const BigNumber a(p_a);
-        if ((a % m_N).is_zero())
+        // S = (A * v^u)^b % N
+#if defined(CRYPTO_NATIVE_SRP6)
+        auto &field = montgomery();
+        const auto a = field.to_montgomery(Uint256(p_a));
+        if (a.is_zero())
+            return std::nullopt;
+
+        const Uint256 u(SHA1::digest_of(p_a, B));
+        const auto v_u = field.mod_exp(field.to_montgomery(m_v), u, 8 * SHA1::disgest_length);
+        const auto base = field.multiply(a, v_u);
+        const EphemeralKey S = field.from_montgomery(field.mod_exp(base, m_b)).to_byte_array<32>();
+#else
+        // A is reduced in place since only its residue takes part
+        BigNumber a(p_a);
+        a %= m_N;
+        if (a.is_zero())
             return std::nullopt;
 
         const BigNumber u(SHA1::digest_of(p_a, B));
-        const EphemeralKey S = (a * (m_v.mod_exp(u, m_N))).mod_exp(m_b, N).to_byte_array<32>();
+        auto &mont = montgomery();
+        auto base = mont.mod_exp(m_v, u);
+        base.mod_mul(a, m_N);
+        const EphemeralKey S = mont.mod_exp(base, m_b).to_byte_array<32>();
+#endif
         auto key = SHA1_inter_leave(S);
-        const SHA1::Digest n_hash = SHA1::digest_of(N);
-        const SHA1::Digest g_hash = SHA1::digest_of(g);
-
-        SHA1::Digest ng_hash;
-        std::transform(n_hash.begin(), n_hash.end(), g_hash.begin(), ng_hash.begin(), std::bit_xor<>());
-
-        const SHA1::Digest m = SHA1::digest_of(ng_hash, m_I, s, p_a, B, key);
+        const SHA1::Digest m = SHA1::digest_of(ng_hash(), m_I, s, p_a, B, key);
         if (m == p_m)
             return key;
         return std::nullopt;
@@ -18,7 +18,12 @@
 #pragma once
 
 #include <Crypto/BigNumber.hpp>
+#include <Crypto/FixedBaseTable.hpp>
 #include <Crypto/GenericHash.hpp>
+#include <Crypto/MontgomeryContext.hpp>
+#if defined(CRYPTO_NATIVE_SRP6)
+#include <Crypto/Montgomery256.hpp>
+#endif
 #include <array>
 #include <optional>
 #include <string>
@@ -40,21 +45,37 @@ namespace Crypto
         static const std::array<std::uint8_t, 1> g;
         static const std::array<std::uint8_t, 32> N;
 
+        static void init();
         static SHA1::Digest session_verifier(const EphemeralKey &p_a, const SHA1::Digest &p_m, const SessionKey &key);
 
         Srp6(const std::string &username, const Salt &salt, const Verifier &verifier);
         std::optional<SessionKey> verify_challenge(const EphemeralKey &p_a, const SHA1::Digest &p_m);
 
     private:
+#if defined(CRYPTO_NATIVE_SRP6)
+        using Number = Uint256;
+        using Field = Montgomery256;
+        using GeneratorTable = Montgomery256::FixedBaseTable;
+#else
+        using Number = BigNumber;
+        using Field = MontgomeryContext;
+        using GeneratorTable = FixedBaseTable;
+
         static const BigNumber m_g;
         static const BigNumber m_N;
+        static const BigNumber m_k;
+#endif
 
         const SHA1::Digest m_I;
-        const BigNumber m_b;
-        const BigNumber m_v;
+        const Number m_b;
+        const Number m_v;
         bool m_used{false};
 
-        static EphemeralKey calculate_B(const BigNumber &b, const BigNumber &v);
+        // SHA1(N) xor SHA1(g), the same for every proof
+        static const SHA1::Digest &ng_hash();
+        static const Field &montgomery();
+        static const GeneratorTable &g_table();
+        static EphemeralKey calculate_B(const Number &b, const Number &v);
         static Srp6::SessionKey SHA1_inter_leave(const EphemeralKey &S);
 
     public:
@@ -0,0 +1,58 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Crypto
+{
+    // Fixed-width 256-bit unsigned integer kept in four little-endian 64-bit limbs
+    class Uint256
+    {
+    public:
+        static constexpr std::size_t limb_count = 4;
+        static constexpr std::size_t byte_count = limb_count * sizeof(std::uint64_t);
+        using Limbs = std::array<std::uint64_t, limb_count>;
+
+        constexpr Uint256() = default;
+        constexpr Uint256(std::uint64_t value) : m_limbs{value} {}
+        template <std::size_t Size> Uint256(const std::array<std::uint8_t, Size> &value)
+        {
+            static_assert(Size <= byte_count);
+            for (std::size_t i = 0; i < Size; i++)
+                m_limbs[i / sizeof(std::uint64_t)] |= std::uint64_t(value[i]) << (8 * (i % sizeof(std::uint64_t)));
+        }
+
+        auto &limbs() { return m_limbs; }
+        const auto &limbs() const { return m_limbs; }
+
+        template <std::size_t Size> std::array<std::uint8_t, Size> to_byte_array() const
+        {
+            std::array<std::uint8_t, Size> result{};
+            for (std::size_t i = 0; i < Size && i < byte_count; i++)
+                result[i] = std::uint8_t(m_limbs[i / sizeof(std::uint64_t)] >> (8 * (i % sizeof(std::uint64_t))));
+            return result;
+        }
+
+        bool is_zero() const { return !(m_limbs[0] | m_limbs[1] | m_limbs[2] | m_limbs[3]); }
+
+    private:
+        Limbs m_limbs{};
+    };
+} // namespace Crypto
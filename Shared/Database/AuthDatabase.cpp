@@ -21,7 +21,27 @@ namespace Database
 {
     AuthDatabase *AuthDatabase::m_instance = nullptr;
 
-    AuthDatabase::AuthDatabase() : Connection("127.0.0.1", 3306, "root", "root", "auth") {}
+    AuthDatabase::AuthDatabase() : ConnectionPool("127.0.0.1", 3306, "root", "root", "auth")
+    {
+        prepare_statement(auth_select_account_by_username, "account",
+                          "SELECT id, username, salt, verifier FROM account WHERE username = ?");
+        prepare_statement(auth_select_character_counts, "characters",
+                          "SELECT realm_id, count FROM characters WHERE account_id = ?");
+        prepare_statement(auth_select_builds, "builds", "SELECT build, major, minor, revision FROM build_information");
+        prepare_statement(auth_select_realms, "realms",
+                          "SELECT id, name, address, local_address, local_subnet_mask, port, type, flags, category, "
+                          "population, build, CAST(UNIX_TIMESTAMP(updated_at) AS UNSIGNED) FROM realmlist "
+                          "WHERE flags <> 3");
+        prepare_statement(auth_select_changed_realms, "changed_realms",
+                          "SELECT id, name, address, local_address, local_subnet_mask, port, type, flags, category, "
+                          "population, build, CAST(UNIX_TIMESTAMP(updated_at) AS UNSIGNED) FROM realmlist "
+                          "WHERE updated_at >= FROM_UNIXTIME(?)");
+        prepare_statement(auth_select_realm_ids, "realm_ids", "SELECT id FROM realmlist WHERE flags <> 3");
+        prepare_statement(auth_update_realm_set_flags, "realm_set_flags",
+                          "UPDATE realmlist SET flags = flags | ? WHERE id = ?");
+        prepare_statement(auth_update_realm_clear_flags, "realm_clear_flags",
+                          "UPDATE realmlist SET flags = flags & ~? WHERE id = ?");
+    }
 
     AuthDatabase *AuthDatabase::instance()
     {
@@ -17,11 +17,24 @@
  */
 #pragma once
 
-#include <Database/Connection.hpp>
+#include <Database/ConnectionPool.hpp>
 
 namespace Database
 {
-    class AuthDatabase : public Connection
+    enum AuthDatabaseStatements : std::uint32_t
+    {
+        auth_select_account_by_username,
+        auth_select_character_counts,
+        auth_select_builds,
+        auth_select_realms,
+        auth_select_changed_realms,
+        auth_select_realm_ids,
+        auth_update_realm_set_flags,
+        auth_update_realm_clear_flags,
+        max_auth_statements
+    };
+
+    class AuthDatabase : public ConnectionPool
     {
     public:
         AuthDatabase();
@@ -0,0 +1,86 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Database/ColumnBatch.hpp>
+#include <cassert>
+
+namespace Database
+{
+    const Field &ColumnBatch::get(std::size_t column, std::size_t row) const
+    {
+        assert(column < m_columns.size() && row < m_row_count);
+        return m_columns[column].fields[row];
+    }
+
+    const std::vector<Field> &ColumnBatch::column(std::size_t index) const
+    {
+        assert(index < m_columns.size());
+        return m_columns[index].fields;
+    }
+
+    void ColumnBatch::clear()
+    {
+        // Buffers keep their capacity so a batch reused across fetches stops allocating once warmed up
+        for (auto &column : m_columns)
+        {
+            column.data.clear();
+            column.offsets.clear();
+            column.lengths.clear();
+            column.fields.clear();
+        }
+        m_row_count = 0;
+    }
+
+    void ColumnBatch::reset(const std::vector<QueryResultField> &metadata)
+    {
+        clear();
+        m_columns.resize(metadata.size());
+        for (std::size_t i = 0; i < metadata.size(); i++)
+            m_columns[i].metadata = &metadata[i];
+    }
+
+    void ColumnBatch::append(std::size_t column, const char *value, std::uint32_t length)
+    {
+        auto &target = m_columns[column];
+        if (!value)
+        {
+            target.offsets.push_back(null_offset);
+            target.lengths.push_back(0);
+            return;
+        }
+
+        target.offsets.push_back(target.data.size());
+        target.lengths.push_back(length);
+        target.data.insert(target.data.end(), value, value + length);
+        target.data.push_back('\0');
+    }
+
+    void ColumnBatch::finalize()
+    {
+        for (auto &column : m_columns)
+        {
+            column.fields.resize(m_row_count);
+            for (std::size_t row = 0; row < m_row_count; row++)
+            {
+                auto offset = column.offsets[row];
+                auto &field = column.fields[row];
+                field.set_metadata(column.metadata);
+                field.set_data(offset == null_offset ? nullptr : column.data.data() + offset, column.lengths[row]);
+            }
+        }
+    }
+} // namespace Database
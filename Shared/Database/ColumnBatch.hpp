@@ -0,0 +1,61 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Database/Field.hpp>
+#include <Database/QueryResultField.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Database
+{
+    class ColumnBatch
+    {
+        friend class ResultSet;
+
+    public:
+        auto row_count() const { return m_row_count; }
+        auto field_count() const { return m_columns.size(); }
+
+        const Field &get(std::size_t column, std::size_t row) const;
+        const std::vector<Field> &column(std::size_t index) const;
+
+        void clear();
+
+    protected:
+        void reset(const std::vector<QueryResultField> &metadata);
+        void append(std::size_t column, const char *value, std::uint32_t length);
+        void complete_row() { m_row_count++; }
+        void finalize();
+
+    private:
+        static constexpr auto null_offset = static_cast<std::size_t>(-1);
+
+        struct Column
+        {
+            const QueryResultField *metadata{nullptr};
+            std::vector<char> data;
+            std::vector<std::size_t> offsets;
+            std::vector<std::uint32_t> lengths;
+            std::vector<Field> fields;
+        };
+
+        std::vector<Column> m_columns;
+        std::size_t m_row_count{0};
+    };
+} // namespace Database
@@ -17,14 +17,41 @@
  */
 #include <Database/Connection.hpp>
 #include <Utilities/Log.hpp>
+#include <cstring>
+#include <mysql/errmsg.h>
+#include <type_traits>
 
 namespace Database
 {
+    template <typename T> static constexpr enum_field_types mysql_type()
+    {
+        if constexpr (sizeof(T) == 1)
+            return MYSQL_TYPE_TINY;
+        else if constexpr (sizeof(T) == 2)
+            return MYSQL_TYPE_SHORT;
+        else if constexpr (std::is_floating_point_v<T>)
+            return MYSQL_TYPE_FLOAT;
+        else if constexpr (sizeof(T) == 4)
+            return MYSQL_TYPE_LONG;
+        else
+            return MYSQL_TYPE_LONGLONG;
+    }
+
+    // Error paths of the queries, which tell a failure apart from an empty result through failed
+    static std::nullptr_t failure(bool *failed)
+    {
+        if (failed)
+            *failed = true;
+        return nullptr;
+    }
+
     Connection::Connection(const char *host, int port, const char *user, const char *password, const char *database)
         : m_host(host), m_port(port), m_user(user), m_password(password), m_database(database)
     {
     }
 
+    Connection::~Connection() { close(); }
+
     std::uint32_t Connection::open()
     {
         auto init = mysql_init(nullptr);
@@ -50,11 +77,26 @@ namespace Database
                   m_database);
         mysql_autocommit(m_handler, true);
         mysql_set_character_set(m_handler, "utf8");
+
+        for (auto &statement : m_statements)
+        {
+            if (!statement.sql.empty() && !prepare_statement(statement))
+                return mysql_errno(m_handler);
+        }
         return 0;
     }
 
     void Connection::close()
     {
+        for (auto &statement : m_statements)
+        {
+            if (statement.handler)
+            {
+                mysql_stmt_close(statement.handler);
+                statement.handler = nullptr;
+            }
+        }
+
         if (m_handler)
         {
             mysql_close(m_handler);
@@ -62,29 +104,52 @@ namespace Database
         }
     }
 
-    ResultSet *Connection::query(const char *sql)
+    bool Connection::ping() { return m_handler && mysql_ping(m_handler) == 0; }
+
+    bool Connection::reconnect()
+    {
+        LOG_WARN("Reconnecting to MySQL Database host = {}, port = {}, database = {}", m_host, m_port, m_database);
+        close();
+        return open() == 0;
+    }
+
+    bool Connection::prepare(std::uint32_t index, std::string sql)
+    {
+        if (index >= m_statements.size())
+            m_statements.resize(index + 1);
+
+        auto &statement = m_statements[index];
+        statement.sql = std::move(sql);
+        return !m_handler || prepare_statement(statement);
+    }
+
+    ResultSet *Connection::query(const char *sql, bool *failed)
     {
         if (!sql)
-            return nullptr;
+            return failure(failed);
 
         if (!m_handler)
-            return nullptr;
+            return failure(failed);
 
         if (mysql_query(m_handler, sql) != 0)
         {
             LOG_ERROR("Failed to query sql = {}, error = {}", sql, mysql_error(m_handler));
-            return nullptr;
+            if (!connection_lost() || !reconnect() || mysql_query(m_handler, sql) != 0)
+                return failure(failed);
         }
         else
             LOG_DEBUG("Successfully query sql = {}", sql);
 
         auto result = mysql_store_result(m_handler);
         if (!result)
-            return nullptr;
+            return mysql_errno(m_handler) ? failure(failed) : nullptr;
 
         auto row_count = mysql_affected_rows(m_handler);
         if (!row_count)
+        {
+            mysql_free_result(result);
             return nullptr;
+        }
 
         auto field_count = mysql_field_count(m_handler);
         auto fields = mysql_fetch_fields(result);
@@ -97,6 +162,37 @@ namespace Database
         return result_set;
     }
 
+    ResultSet *Connection::stream(const char *sql, bool *failed)
+    {
+        if (!sql || !m_handler)
+            return failure(failed);
+
+        if (mysql_query(m_handler, sql) != 0)
+        {
+            LOG_ERROR("Failed to stream sql = {}, error = {}", sql, mysql_error(m_handler));
+            if (!connection_lost() || !reconnect() || mysql_query(m_handler, sql) != 0)
+                return failure(failed);
+        }
+        else
+            LOG_DEBUG("Successfully stream sql = {}", sql);
+
+        // Rows are read from the server as the caller iterates, so the row count is unknown up front
+        auto result = mysql_use_result(m_handler);
+        if (!result)
+            return failure(failed);
+
+        auto field_count = mysql_field_count(m_handler);
+        auto fields = mysql_fetch_fields(result);
+        auto result_set = new ResultSet(result, fields, 0, field_count, m_handler);
+        if (!result_set->next_row())
+        {
+            auto stream_failed = result_set->failed();
+            delete result_set;
+            return stream_failed ? failure(failed) : nullptr;
+        }
+        return result_set;
+    }
+
     bool Connection::execute(const char *sql)
     {
         if (!m_handler)
@@ -105,10 +201,199 @@ namespace Database
         if (mysql_query(m_handler, sql) != 0)
         {
             LOG_ERROR("Failed to execute sql = {}, error = {}", sql, mysql_error(m_handler));
+            // The statement may have been applied before the link dropped, so it is not run a second time
+            if (connection_lost())
+                reconnect();
             return false;
         }
         else
             LOG_DEBUG("Successfully execute sql = {}", sql);
         return true;
     }
+
+    PreparedResultSet *Connection::query(const PreparedStatement &statement, bool *failed)
+    {
+        auto handler = execute_statement(statement, true);
+        if (!handler)
+            return failure(failed);
+
+        if (mysql_stmt_store_result(handler) != 0)
+        {
+            LOG_ERROR("Failed to store prepared statement result, index = {}, error = {}", statement.index(),
+                      mysql_stmt_error(handler));
+            return failure(failed);
+        }
+
+        auto metadata = mysql_stmt_result_metadata(handler);
+        if (!metadata)
+        {
+            mysql_stmt_free_result(handler);
+            return failure(failed);
+        }
+
+        auto result_set = new PreparedResultSet(handler, metadata, mysql_stmt_field_count(handler));
+        if (!result_set->row_count())
+        {
+            delete result_set;
+            return nullptr;
+        }
+        return result_set;
+    }
+
+    bool Connection::execute(const PreparedStatement &statement) { return execute_statement(statement, false); }
+
+    bool Connection::transaction(const std::vector<PreparedStatement> &statements)
+    {
+        if (!m_handler)
+            return false;
+
+        // Statements are not retried individually, a lost connection fails the whole transaction
+        if (mysql_query(m_handler, "START TRANSACTION") != 0)
+        {
+            LOG_ERROR("Failed to start transaction, error = {}", mysql_error(m_handler));
+            if (connection_lost())
+                reconnect();
+            return false;
+        }
+
+        for (const auto &statement : statements)
+        {
+            // A lost connection has been reopened by now, which already dropped the transaction
+            if (!execute_statement(statement, false))
+            {
+                LOG_ERROR("Failed to execute prepared statement in transaction, index = {}", statement.index());
+                if (m_handler)
+                    mysql_rollback(m_handler);
+                return false;
+            }
+        }
+
+        if (mysql_commit(m_handler))
+        {
+            LOG_ERROR("Failed to commit transaction, error = {}", mysql_error(m_handler));
+            if (connection_lost())
+                reconnect();
+            return false;
+        }
+
+        LOG_DEBUG("Successfully commit transaction with {} statements", statements.size());
+        return true;
+    }
+
+    bool Connection::connection_lost() const
+    {
+        return connection_lost(mysql_errno(m_handler));
+    }
+
+    bool Connection::connection_lost(unsigned int error)
+    {
+        return error == CR_SERVER_GONE_ERROR || error == CR_SERVER_LOST;
+    }
+
+    bool Connection::prepare_statement(Statement &statement)
+    {
+        statement.handler = mysql_stmt_init(m_handler);
+        if (!statement.handler)
+        {
+            LOG_ERROR("Failed to initialize prepared statement, error = {}", mysql_error(m_handler));
+            return false;
+        }
+
+        if (mysql_stmt_prepare(statement.handler, statement.sql.c_str(), statement.sql.size()) != 0)
+        {
+            LOG_ERROR("Failed to prepare sql = {}, error = {}", statement.sql, mysql_stmt_error(statement.handler));
+            mysql_stmt_close(statement.handler);
+            statement.handler = nullptr;
+            return false;
+        }
+
+        // Let mysql_stmt_store_result report column widths so results can be bound without truncation
+        bool update_max_length = true;
+        mysql_stmt_attr_set(statement.handler, STMT_ATTR_UPDATE_MAX_LENGTH, &update_max_length);
+        return true;
+    }
+
+    MYSQL_STMT *Connection::execute_statement(const PreparedStatement &statement, bool retry)
+    {
+        if (!m_handler || statement.index() >= m_statements.size())
+            return nullptr;
+
+        auto handler = m_statements[statement.index()].handler;
+        if (!handler)
+        {
+            LOG_ERROR("Prepared statement is not registered, index = {}", statement.index());
+            return nullptr;
+        }
+
+        if (!bind_parameters(handler, statement))
+            return nullptr;
+
+        if (mysql_stmt_execute(handler) != 0)
+        {
+            LOG_ERROR("Failed to execute prepared sql = {}, error = {}", m_statements[statement.index()].sql,
+                      mysql_stmt_error(handler));
+            if (!connection_lost(mysql_stmt_errno(handler)) || !reconnect() || !retry)
+                return nullptr;
+
+            handler = m_statements[statement.index()].handler;
+            if (!handler || !bind_parameters(handler, statement) || mysql_stmt_execute(handler) != 0)
+                return nullptr;
+        }
+        return handler;
+    }
+
+    bool Connection::bind_parameters(MYSQL_STMT *handler, const PreparedStatement &statement)
+    {
+        const auto &parameters = statement.parameters();
+        if (parameters.size() != mysql_stmt_param_count(handler))
+        {
+            LOG_ERROR("Prepared statement parameter count mismatch, index = {}, expected = {}, bound = {}",
+                      statement.index(), mysql_stmt_param_count(handler), parameters.size());
+            return false;
+        }
+
+        if (parameters.empty())
+            return true;
+
+        std::vector<MYSQL_BIND> binds(parameters.size());
+        for (std::size_t i = 0; i < parameters.size(); i++)
+        {
+            auto &bind = binds[i];
+            std::memset(&bind, 0, sizeof(bind));
+            std::visit(
+                [&bind](const auto &value) {
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, std::monostate>)
+                        bind.buffer_type = MYSQL_TYPE_NULL;
+                    else if constexpr (std::is_same_v<T, std::string>)
+                    {
+                        bind.buffer_type = MYSQL_TYPE_STRING;
+                        bind.buffer = const_cast<char *>(value.data());
+                        bind.buffer_length = value.size();
+                    }
+                    else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>)
+                    {
+                        bind.buffer_type = MYSQL_TYPE_BLOB;
+                        bind.buffer = const_cast<std::uint8_t *>(value.data());
+                        bind.buffer_length = value.size();
+                    }
+                    else
+                    {
+                        bind.buffer_type = mysql_type<T>();
+                        bind.buffer = const_cast<T *>(&value);
+                        bind.is_unsigned = std::is_unsigned_v<T>;
+                    }
+                },
+                parameters[i]);
+        }
+
+        // mysql_stmt_bind_param copies the bind descriptors, the values are read on execute
+        if (mysql_stmt_bind_param(handler, binds.data()))
+        {
+            LOG_ERROR("Failed to bind prepared statement parameters, index = {}, error = {}", statement.index(),
+                      mysql_stmt_error(handler));
+            return false;
+        }
+        return true;
+    }
 } // namespace Database
@@ -17,9 +17,13 @@
  */
 #pragma once
 
+#include <Database/PreparedResultSet.hpp>
+#include <Database/PreparedStatement.hpp>
 #include <Database/ResultSet.hpp>
 #include <cstdint>
 #include <mysql/mysql.h>
+#include <string>
+#include <vector>
 
 namespace Database
 {
@@ -27,18 +31,42 @@ namespace Database
     {
     public:
         Connection(const char *host, int port, const char *user, const char *password, const char *database);
+        ~Connection();
 
         std::uint32_t open();
         void close();
-        ResultSet *query(const char *sql);
+        bool ping();
+        bool reconnect();
+        bool prepare(std::uint32_t index, std::string sql);
+        // Queries only read, so they are run again once after a lost connection is reopened. Executes are not, a
+        // statement applied just before the link dropped would be applied twice, the caller gets the failure instead.
+        // Queries return null for empty results too, failed is only set when the query itself did not succeed
+        ResultSet *query(const char *sql, bool *failed = nullptr);
+        PreparedResultSet *query(const PreparedStatement &statement, bool *failed = nullptr);
+        ResultSet *stream(const char *sql, bool *failed = nullptr);
         bool execute(const char *sql);
+        bool execute(const PreparedStatement &statement);
+        bool transaction(const std::vector<PreparedStatement> &statements);
 
     private:
-        MYSQL *m_handler;
+        struct Statement
+        {
+            std::string sql;
+            MYSQL_STMT *handler{nullptr};
+        };
+
+        MYSQL *m_handler{nullptr};
         int m_port{-1};
         const char *m_host{nullptr};
         const char *m_user{nullptr};
         const char *m_password{nullptr};
         const char *m_database{nullptr};
+        std::vector<Statement> m_statements;
+
+        bool connection_lost() const;
+        static bool connection_lost(unsigned int error);
+        bool prepare_statement(Statement &statement);
+        MYSQL_STMT *execute_statement(const PreparedStatement &statement, bool retry);
+        bool bind_parameters(MYSQL_STMT *handler, const PreparedStatement &statement);
     };
 } // namespace Database
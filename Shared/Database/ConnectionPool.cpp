@@ -0,0 +1,345 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Database/ConnectionPool.hpp>
+#include <Database/ResultCursor.hpp>
+#include <Utilities/Log.hpp>
+#include <algorithm>
+
+namespace Database
+{
+    ConnectionPool::Handle::~Handle()
+    {
+        if (m_pool)
+            m_pool->release(m_index);
+    }
+
+    Connection *ConnectionPool::Handle::operator->() const { return m_pool->m_slots[m_index].connection.get(); }
+
+    ConnectionPool::ConnectionPool(const char *host, int port, const char *user, const char *password,
+                                   const char *database)
+        : m_port(port), m_host(host), m_user(user), m_password(password), m_database(database)
+    {
+    }
+
+    ConnectionPool::~ConnectionPool() { close(); }
+
+    std::uint32_t ConnectionPool::open(std::size_t connection_count)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        std::vector<std::unique_ptr<Connection>> connections;
+        for (std::size_t i = 0; i < connection_count; i++)
+        {
+            auto connection = std::make_unique<Connection>(m_host, m_port, m_user, m_password, m_database);
+            for (std::uint32_t index = 0; index < m_statements.size(); index++)
+                connection->prepare(index, m_statements[index].sql);
+
+            // The pool opens whole or not at all, connections opened so far close as they go out of scope
+            if (auto error = connection->open())
+                return error;
+            connections.push_back(std::move(connection));
+        }
+
+        for (auto &connection : connections)
+        {
+            auto &slot = m_slots.emplace_back();
+            slot.connection = std::move(connection);
+            slot.last_used = std::chrono::steady_clock::now();
+            m_free.push_back(m_slots.size() - 1);
+        }
+
+        m_opened = std::chrono::steady_clock::now();
+        m_statistics_logged = m_opened;
+        m_workers = std::make_unique<Thread::WorkerPool>(connection_count);
+        LOG_DEBUG("Opened database pool with {} connections, database = {}", connection_count, m_database);
+        return 0;
+    }
+
+    std::optional<std::uint32_t> ConnectionPool::add_statement(std::string name, std::string sql)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_slots.empty())
+        {
+            LOG_ERROR("Failed to add statement = {}, the pool is already open, database = {}", name, m_database);
+            return std::nullopt;
+        }
+
+        m_statements.push_back({std::move(name), std::move(sql)});
+        return std::uint32_t(m_statements.size() - 1);
+    }
+
+    void ConnectionPool::close()
+    {
+        m_workers.reset();
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (m_slots.empty())
+            return;
+
+        m_closing = true;
+        m_condition.notify_all();
+        m_condition.wait(lock, [this]() { return m_free.size() == m_slots.size(); });
+        m_free.clear();
+        m_slots.clear();
+        m_closing = false;
+    }
+
+    ConnectionPool::Handle ConnectionPool::checkout()
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (m_slots.empty() || m_closing)
+            return Handle(nullptr, 0);
+
+        m_condition.wait(lock, [this]() { return m_closing || !m_free.empty(); });
+        if (m_closing)
+            return Handle(nullptr, 0);
+
+        auto index = m_free.back();
+        m_free.pop_back();
+
+        auto now = std::chrono::steady_clock::now();
+        auto wait = now - start;
+        m_checkouts++;
+        m_total_wait += wait;
+        m_max_wait = std::max(m_max_wait, wait);
+
+        auto &slot = m_slots[index];
+        slot.checked_out = now;
+        auto log_due = now - m_statistics_logged >= statistics_log_interval;
+        if (log_due)
+            m_statistics_logged = now;
+        lock.unlock();
+
+        if (log_due)
+            log_statistics();
+        health_check(slot);
+        return Handle(this, index);
+    }
+
+    ResultSet *ConnectionPool::query(const char *sql, bool *failed)
+    {
+        if (auto connection = checkout())
+            return connection->query(sql, failed);
+        if (failed)
+            *failed = true;
+        return nullptr;
+    }
+
+    PreparedResultSet *ConnectionPool::query(const PreparedStatement &statement, bool *failed)
+    {
+        if (auto connection = checkout())
+            return connection->query(statement, failed);
+        if (failed)
+            *failed = true;
+        return nullptr;
+    }
+
+    std::unique_ptr<ResultCursor> ConnectionPool::stream(const char *sql, bool *failed)
+    {
+        auto connection = checkout();
+        if (!connection)
+        {
+            if (failed)
+                *failed = true;
+            return nullptr;
+        }
+
+        std::unique_ptr<ResultSet> result(connection->stream(sql, failed));
+        if (!result)
+            return nullptr;
+        return std::make_unique<ResultCursor>(std::move(connection), std::move(result));
+    }
+
+    std::unique_ptr<ResultCursor> ConnectionPool::stream(const PreparedStatement &statement, bool *failed)
+    {
+        if (!statement.parameters().empty() || statement.index() >= m_statements.size())
+        {
+            LOG_ERROR("Only registered statements without parameters can be streamed, index = {}", statement.index());
+            if (failed)
+                *failed = true;
+            return nullptr;
+        }
+        return stream(m_statements[statement.index()].sql.c_str(), failed);
+    }
+
+    bool ConnectionPool::execute(const char *sql)
+    {
+        if (auto connection = checkout())
+            return connection->execute(sql);
+        return false;
+    }
+
+    bool ConnectionPool::execute(const PreparedStatement &statement)
+    {
+        if (auto connection = checkout())
+            return connection->execute(statement);
+        return false;
+    }
+
+    void ConnectionPool::async_query(std::string type, std::string sql, QueryCallback callback)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run_async(
+            [this, start, type = std::move(type), sql = std::move(sql), callback = std::move(callback)]() {
+                std::unique_ptr<ResultSet> result(query(sql.c_str()));
+                m_statistics.record(type, std::chrono::steady_clock::now() - start);
+                callback(std::move(result));
+            },
+            "query");
+    }
+
+    void ConnectionPool::async_query(PreparedStatement statement, PreparedQueryCallback callback)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run_async(
+            [this, start, statement = std::move(statement), callback = std::move(callback)]() {
+                std::unique_ptr<PreparedResultSet> result(query(statement));
+                m_statistics.record(statement_name(statement), std::chrono::steady_clock::now() - start);
+                callback(std::move(result));
+            },
+            "query");
+    }
+
+    void ConnectionPool::async_execute(std::string type, std::string sql, ExecuteCallback callback)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run_async(
+            [this, start, type = std::move(type), sql = std::move(sql), callback = std::move(callback)]() {
+                auto result = execute(sql.c_str());
+                m_statistics.record(type, std::chrono::steady_clock::now() - start);
+                if (callback)
+                    callback(result);
+            },
+            "execute");
+    }
+
+    void ConnectionPool::async_execute(PreparedStatement statement, ExecuteCallback callback)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run_async(
+            [this, start, statement = std::move(statement), callback = std::move(callback)]() {
+                auto result = execute(statement);
+                m_statistics.record(statement_name(statement), std::chrono::steady_clock::now() - start);
+                if (callback)
+                    callback(result);
+            },
+            "execute");
+    }
+
+    ConnectionPool::Statistics ConnectionPool::pool_statistics() const
+    {
+        using Microseconds = std::chrono::duration<double, std::micro>;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto now = std::chrono::steady_clock::now();
+        auto busy_time = m_busy_time;
+        for (std::size_t i = 0; i < m_slots.size(); i++)
+        {
+            if (std::find(m_free.begin(), m_free.end(), i) == m_free.end())
+                busy_time += now - m_slots[i].checked_out;
+        }
+
+        Statistics statistics;
+        statistics.size = m_slots.size();
+        statistics.in_use = m_slots.size() - m_free.size();
+        statistics.checkouts = m_checkouts;
+        statistics.reconnects = m_reconnects;
+        statistics.max_wait_us = Microseconds(m_max_wait).count();
+        if (m_checkouts)
+            statistics.average_wait_us = Microseconds(m_total_wait).count() / double(m_checkouts);
+
+        auto capacity = double((now - m_opened).count()) * double(m_slots.size());
+        if (capacity > 0)
+            statistics.utilisation = double(busy_time.count()) / capacity;
+        return statistics;
+    }
+
+    void ConnectionPool::log_statistics() const
+    {
+        auto pool = pool_statistics();
+        LOG_DEBUG("Database pool, database = {}, in use = {}/{}, checkouts = {}, average wait = {:.1f} us, "
+                  "max wait = {:.1f} us, utilisation = {:.3f}, reconnects = {}",
+                  m_database, pool.in_use, pool.size, pool.checkouts, pool.average_wait_us, pool.max_wait_us,
+                  pool.utilisation, pool.reconnects);
+
+        for (const auto &[type, summary] : m_statistics.summaries())
+            LOG_DEBUG("Database latency, type = {}, count = {}, p50 = {} us, p95 = {} us, p99 = {} us, max = {} us",
+                      type, summary.count, summary.p50, summary.p95, summary.p99, summary.max);
+    }
+
+    void ConnectionPool::release(std::size_t index)
+    {
+        bool closing;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            auto &slot = m_slots[index];
+            slot.last_used = std::chrono::steady_clock::now();
+            m_busy_time += slot.last_used - slot.checked_out;
+            m_free.push_back(index);
+            closing = m_closing;
+        }
+
+        // close waits on the same condition as checkout, so it has to be woken whichever thread would be picked
+        if (closing)
+            m_condition.notify_all();
+        else
+            m_condition.notify_one();
+    }
+
+    void ConnectionPool::prepare_statement(std::uint32_t index, std::string name, std::string sql)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (index >= m_statements.size())
+            m_statements.resize(index + 1);
+        m_statements[index] = {std::move(name), std::move(sql)};
+    }
+
+    void ConnectionPool::run_async(std::function<void()> task, const char *operation)
+    {
+        if (!m_workers || !m_workers->enqueue(task))
+        {
+            LOG_ERROR("Database worker queue unavailable, running {} inline", operation);
+            task();
+        }
+    }
+
+    const std::string &ConnectionPool::statement_name(const PreparedStatement &statement) const
+    {
+        static const std::string unknown = "unknown";
+        if (statement.index() >= m_statements.size())
+            return unknown;
+        return m_statements[statement.index()].name;
+    }
+
+    void ConnectionPool::health_check(Slot &slot)
+    {
+        if (std::chrono::steady_clock::now() - slot.last_used < health_check_interval)
+            return;
+
+        if (slot.connection->ping())
+            return;
+
+        LOG_WARN("Database connection failed health check, database = {}", m_database);
+        if (slot.connection->reconnect())
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_reconnects++;
+        }
+    }
+} // namespace Database
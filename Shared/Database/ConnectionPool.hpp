@@ -0,0 +1,151 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Database/Connection.hpp>
+#include <Database/QueryStatistics.hpp>
+#include <Thread/WorkerPool.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Database
+{
+    class ResultCursor;
+
+    class ConnectionPool
+    {
+    public:
+        using QueryCallback = std::function<void(std::unique_ptr<ResultSet>)>;
+        using PreparedQueryCallback = std::function<void(std::unique_ptr<PreparedResultSet>)>;
+        using ExecuteCallback = std::function<void(bool)>;
+
+        struct Statistics
+        {
+            std::size_t size{0};
+            std::size_t in_use{0};
+            std::uint64_t checkouts{0};
+            std::uint64_t reconnects{0};
+            double average_wait_us{0.0};
+            double max_wait_us{0.0};
+            double utilisation{0.0};
+        };
+
+        class Handle
+        {
+        public:
+            Handle(ConnectionPool *pool, std::size_t index) : m_pool(pool), m_index(index) {}
+            Handle(const Handle &) = delete;
+            Handle(Handle &&right) noexcept : m_pool(std::exchange(right.m_pool, nullptr)), m_index(right.m_index) {}
+            ~Handle();
+
+            Handle &operator=(const Handle &) = delete;
+            Handle &operator=(Handle &&) = delete;
+
+            Connection *operator->() const;
+            explicit operator bool() const { return m_pool; }
+
+        private:
+            ConnectionPool *m_pool;
+            std::size_t m_index;
+        };
+
+        ConnectionPool(const char *host, int port, const char *user, const char *password, const char *database);
+        virtual ~ConnectionPool();
+
+        std::uint32_t open(std::size_t connection_count = 1);
+        // Registers a statement after the fixed ones, connections only prepare statements registered before open
+        std::optional<std::uint32_t> add_statement(std::string name, std::string sql);
+        // Fails pending and later checkouts, then waits for every checked out handle, so the calling thread must not
+        // hold one
+        void close();
+        // Null once the pool is closed or closing
+        Handle checkout();
+        // Null results are empty unless failed is set, which also covers running out of connections
+        ResultSet *query(const char *sql, bool *failed = nullptr);
+        PreparedResultSet *query(const PreparedStatement &statement, bool *failed = nullptr);
+        std::unique_ptr<ResultCursor> stream(const char *sql, bool *failed = nullptr);
+        // Streams the sql registered for a statement without parameters over the text protocol
+        std::unique_ptr<ResultCursor> stream(const PreparedStatement &statement, bool *failed = nullptr);
+        bool execute(const char *sql);
+        bool execute(const PreparedStatement &statement);
+
+        void async_query(std::string type, std::string sql, QueryCallback callback);
+        void async_query(PreparedStatement statement, PreparedQueryCallback callback);
+        void async_execute(std::string type, std::string sql, ExecuteCallback callback = {});
+        void async_execute(PreparedStatement statement, ExecuteCallback callback = {});
+
+        const auto &statistics() const { return m_statistics; }
+        Statistics pool_statistics() const;
+
+    protected:
+        void prepare_statement(std::uint32_t index, std::string name, std::string sql);
+
+    private:
+        static constexpr auto health_check_interval = std::chrono::seconds(30);
+        static constexpr auto statistics_log_interval = std::chrono::seconds(60);
+
+        struct StatementInfo
+        {
+            std::string name;
+            std::string sql;
+        };
+
+        struct Slot
+        {
+            std::unique_ptr<Connection> connection;
+            std::chrono::steady_clock::time_point last_used;
+            std::chrono::steady_clock::time_point checked_out;
+        };
+
+        int m_port;
+        const char *m_host;
+        const char *m_user;
+        const char *m_password;
+        const char *m_database;
+
+        mutable std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::vector<Slot> m_slots;
+        std::vector<std::size_t> m_free;
+        bool m_closing{false};
+        std::vector<StatementInfo> m_statements;
+        std::unique_ptr<Thread::WorkerPool> m_workers;
+        QueryStatistics m_statistics;
+
+        std::chrono::steady_clock::time_point m_opened;
+        std::chrono::steady_clock::duration m_busy_time{};
+        std::chrono::steady_clock::duration m_total_wait{};
+        std::chrono::steady_clock::duration m_max_wait{};
+        std::uint64_t m_checkouts{0};
+        std::uint64_t m_reconnects{0};
+        std::chrono::steady_clock::time_point m_statistics_logged;
+
+        void release(std::size_t index);
+        void run_async(std::function<void()> task, const char *operation);
+        const std::string &statement_name(const PreparedStatement &statement) const;
+        void health_check(Slot &slot);
+        void log_statistics() const;
+    };
+} // namespace Database
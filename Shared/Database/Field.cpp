@@ -22,13 +22,42 @@
 
 namespace Database
 {
+    template <typename T> T Field::get_raw_value(const char *value)
+    {
+        T result;
+        std::memcpy(&result, value, sizeof(T));
+        return result;
+    }
+
+    template <typename T> T Field::get_raw_number() const
+    {
+        // Binary protocol values keep the column width, so widen or narrow from the declared type
+        switch (m_metadata->type)
+        {
+        case DatabaseFieldTypes::Int8:
+            return static_cast<T>(get_raw_value<std::uint8_t>(m_data.value));
+        case DatabaseFieldTypes::Int16:
+            return static_cast<T>(get_raw_value<std::uint16_t>(m_data.value));
+        case DatabaseFieldTypes::Int32:
+            return static_cast<T>(get_raw_value<std::uint32_t>(m_data.value));
+        case DatabaseFieldTypes::Int64:
+            return static_cast<T>(get_raw_value<std::uint64_t>(m_data.value));
+        case DatabaseFieldTypes::Float:
+            return static_cast<T>(get_raw_value<float>(m_data.value));
+        case DatabaseFieldTypes::Double:
+            return static_cast<T>(get_raw_value<double>(m_data.value));
+        default:
+            return static_cast<T>(std::strtod(m_data.value, nullptr));
+        }
+    }
+
     float Field::get_float() const
     {
         if (!m_data.value)
             return 0.0f;
 
         if (m_data.is_raw)
-            return *reinterpret_cast<const float *>(m_data.value);
+            return get_raw_number<float>();
         return static_cast<float>(std::atof(m_data.value));
     }
 
@@ -38,7 +67,7 @@ namespace Database
             return 0;
 
         if (m_data.is_raw)
-            return *reinterpret_cast<const std::uint8_t *>(m_data.value);
+            return get_raw_number<std::uint8_t>();
         return static_cast<std::uint8_t>(std::strtoul(m_data.value, nullptr, 10));
     }
 
@@ -48,7 +77,7 @@ namespace Database
             return 0;
 
         if (m_data.is_raw)
-            return *reinterpret_cast<const std::uint16_t *>(m_data.value);
+            return get_raw_number<std::uint16_t>();
         return static_cast<std::uint16_t>(std::strtoul(m_data.value, nullptr, 10));
     }
 
@@ -58,10 +87,20 @@ namespace Database
             return 0;
 
         if (m_data.is_raw)
-            return *reinterpret_cast<const std::uint32_t *>(m_data.value);
+            return get_raw_number<std::uint32_t>();
         return static_cast<std::uint32_t>(std::strtoul(m_data.value, nullptr, 10));
     }
 
+    std::uint64_t Field::get_uint64() const
+    {
+        if (!m_data.value)
+            return 0;
+
+        if (m_data.is_raw)
+            return get_raw_number<std::uint64_t>();
+        return static_cast<std::uint64_t>(std::strtoull(m_data.value, nullptr, 10));
+    }
+
     std::string Field::get_string() const
     {
         if (!m_data.value)
@@ -81,11 +120,11 @@ namespace Database
         return static_cast<const char *>(m_data.value);
     }
 
-    void Field::set_data(const char *value, std::uint32_t length)
+    void Field::set_data(const char *value, std::uint32_t length, bool is_raw)
     {
         m_data.value = value;
         m_data.length = length;
-        m_data.is_raw = false;
+        m_data.is_raw = is_raw;
     }
 
     void Field::set_metadata(const QueryResultField *metadata) { m_metadata = metadata; }
@@ -24,16 +24,24 @@
 
 namespace Database
 {
+    class ColumnBatch;
     class ResultSet;
+    class PreparedResultSet;
     class Field
     {
+        friend class ColumnBatch;
         friend class ResultSet;
+        friend class PreparedResultSet;
 
     public:
+        bool is_null() const { return !m_data.value; }
+        std::uint32_t length() const { return m_data.length; }
+
         float get_float() const;
         std::uint8_t get_uint8() const;
         std::uint16_t get_uint16() const;
         std::uint32_t get_uint32() const;
+        std::uint64_t get_uint64() const;
         std::string get_string() const;
         const char *get_c_string() const;
 
@@ -45,7 +53,7 @@ namespace Database
         }
 
     protected:
-        void set_data(const char *value, std::uint32_t length);
+        void set_data(const char *value, std::uint32_t length, bool is_raw = false);
         void set_metadata(const QueryResultField *metadata);
 
     private:
@@ -59,5 +67,8 @@ namespace Database
         const QueryResultField *m_metadata;
 
         void get_binary_sized(std::uint8_t *buffer, std::size_t length) const;
+
+        template <typename T> T get_raw_number() const;
+        template <typename T> static T get_raw_value(const char *value);
     };
 } // namespace Database
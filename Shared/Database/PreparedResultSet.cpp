@@ -0,0 +1,200 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Database/PreparedResultSet.hpp>
+#include <Database/ResultSet.hpp>
+#include <Utilities/Log.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+
+namespace Database
+{
+    PreparedResultSet::PreparedResultSet(MYSQL_STMT *statement, MYSQL_RES *metadata, std::uint32_t field_count)
+        : m_metadata(metadata), m_field_count(field_count)
+    {
+        auto fields = mysql_fetch_fields(m_metadata);
+        m_field_data.resize(m_field_count);
+
+        for (std::uint32_t i = 0; i < m_field_count; i++)
+        {
+            auto meta = &m_field_data[i];
+            auto field = &fields[i];
+
+            meta->table_name = field->org_table;
+            meta->table_alias = field->table;
+            meta->name = field->org_name;
+            meta->alias = field->name;
+            meta->index = i;
+            meta->type = ResultSet::mysql_type_to_field_type(field->type);
+            meta->type_name = ResultSet::field_type_string(field->type);
+        }
+
+        fetch_rows(statement, fields);
+        mysql_stmt_free_result(statement);
+    }
+
+    PreparedResultSet::~PreparedResultSet()
+    {
+        if (m_metadata)
+            mysql_free_result(m_metadata);
+    }
+
+    Field *PreparedResultSet::fetch()
+    {
+        if (m_row_position >= m_row_count)
+            return nullptr;
+        return &m_rows[m_row_position * m_field_count];
+    }
+
+    bool PreparedResultSet::next_row()
+    {
+        if (m_row_position + 1 >= m_row_count)
+            return false;
+
+        m_row_position++;
+        return true;
+    }
+
+    const Field &PreparedResultSet::operator[](std::size_t index) const
+    {
+        assert(index < m_field_count && m_row_position < m_row_count);
+        return m_rows[m_row_position * m_field_count + index];
+    }
+
+    void PreparedResultSet::fetch_rows(MYSQL_STMT *statement, MYSQL_FIELD *fields)
+    {
+        if (!m_field_count || !mysql_stmt_num_rows(statement))
+            return;
+
+        std::vector<MYSQL_BIND> binds(m_field_count);
+        std::vector<unsigned long> lengths(m_field_count);
+        std::vector<std::size_t> offsets(m_field_count);
+        auto nulls = std::make_unique<bool[]>(m_field_count);
+
+        std::size_t row_size = 0;
+        for (std::uint32_t i = 0; i < m_field_count; i++)
+        {
+            offsets[i] = row_size;
+            row_size += buffer_size(fields[i]);
+        }
+
+        std::vector<std::uint8_t> row_buffer(row_size);
+        for (std::uint32_t i = 0; i < m_field_count; i++)
+        {
+            auto &bind = binds[i];
+            std::memset(&bind, 0, sizeof(bind));
+            bind.buffer_type = buffer_type(fields[i].type);
+            bind.buffer = row_buffer.data() + offsets[i];
+            bind.buffer_length = buffer_size(fields[i]);
+            bind.length = &lengths[i];
+            bind.is_null = &nulls[i];
+            bind.is_unsigned = fields[i].flags & UNSIGNED_FLAG;
+        }
+
+        if (mysql_stmt_bind_result(statement, binds.data()))
+        {
+            LOG_ERROR("Failed to bind prepared statement result, error = {}", mysql_stmt_error(statement));
+            return;
+        }
+
+        std::vector<Cell> cells;
+        cells.reserve(mysql_stmt_num_rows(statement) * m_field_count);
+
+        int status;
+        while ((status = mysql_stmt_fetch(statement)) == 0 || status == MYSQL_DATA_TRUNCATED)
+        {
+            if (status == MYSQL_DATA_TRUNCATED)
+                LOG_WARN("Prepared statement result truncated, row = {}", m_row_count);
+
+            for (std::uint32_t i = 0; i < m_field_count; i++)
+            {
+                auto &cell = cells.emplace_back();
+                if (nulls[i])
+                    continue;
+
+                // Values are null terminated so text converted columns can be read as C strings
+                auto length = std::min<std::size_t>(lengths[i], binds[i].buffer_length);
+                auto value = row_buffer.data() + offsets[i];
+                cell.offset = m_storage.size();
+                cell.length = static_cast<std::uint32_t>(length);
+                cell.is_null = false;
+                m_storage.insert(m_storage.end(), value, value + length);
+                m_storage.push_back(0);
+            }
+            m_row_count++;
+        }
+
+        if (status != MYSQL_NO_DATA)
+            LOG_ERROR("Failed to fetch prepared statement row, error = {}", mysql_stmt_error(statement));
+
+        m_rows.resize(cells.size());
+        for (std::size_t i = 0; i < cells.size(); i++)
+        {
+            auto &cell = cells[i];
+            auto value = cell.is_null ? nullptr : reinterpret_cast<const char *>(m_storage.data() + cell.offset);
+            m_rows[i].set_metadata(&m_field_data[i % m_field_count]);
+            m_rows[i].set_data(value, cell.length, true);
+        }
+    }
+
+    std::size_t PreparedResultSet::buffer_size(const MYSQL_FIELD &field)
+    {
+        switch (field.type)
+        {
+        case MYSQL_TYPE_TINY:
+            return 1;
+        case MYSQL_TYPE_YEAR:
+        case MYSQL_TYPE_SHORT:
+            return 2;
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_FLOAT:
+            return 4;
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_BIT:
+        case MYSQL_TYPE_DOUBLE:
+            return 8;
+        default:
+            return field.max_length + 1;
+        }
+    }
+
+    enum_field_types PreparedResultSet::buffer_type(enum_field_types type)
+    {
+        switch (type)
+        {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+            return type;
+        case MYSQL_TYPE_YEAR:
+            return MYSQL_TYPE_SHORT;
+        case MYSQL_TYPE_INT24:
+            return MYSQL_TYPE_LONG;
+        case MYSQL_TYPE_BIT:
+            return MYSQL_TYPE_LONGLONG;
+        default:
+            // Decimals, dates and blobs are fetched as their text or byte representation
+            return MYSQL_TYPE_STRING;
+        }
+    }
+} // namespace Database
@@ -0,0 +1,63 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Database/Field.hpp>
+#include <Database/QueryResultField.hpp>
+#include <mysql/mysql.h>
+#include <vector>
+
+namespace Database
+{
+    class PreparedResultSet
+    {
+    public:
+        PreparedResultSet(PreparedResultSet const &right) = delete;
+        PreparedResultSet &operator=(PreparedResultSet const &right) = delete;
+        PreparedResultSet(MYSQL_STMT *statement, MYSQL_RES *metadata, std::uint32_t field_count);
+        ~PreparedResultSet();
+
+        auto row_count() { return m_row_count; }
+        const auto &metadata() const { return m_field_data; }
+
+        Field *fetch();
+        bool next_row();
+
+        const Field &operator[](std::size_t index) const;
+
+    private:
+        struct Cell
+        {
+            std::size_t offset{0};
+            std::uint32_t length{0};
+            bool is_null{true};
+        };
+
+        MYSQL_RES *m_metadata;
+        std::uint32_t m_field_count;
+        std::uint64_t m_row_count{0};
+        std::uint64_t m_row_position{0};
+        std::vector<QueryResultField> m_field_data;
+        std::vector<std::uint8_t> m_storage;
+        std::vector<Field> m_rows;
+
+        void fetch_rows(MYSQL_STMT *statement, MYSQL_FIELD *fields);
+        static std::size_t buffer_size(const MYSQL_FIELD &field);
+        static enum_field_types buffer_type(enum_field_types type);
+    };
+} // namespace Database
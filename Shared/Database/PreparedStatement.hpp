@@ -0,0 +1,60 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace Database
+{
+    using PreparedStatementData = std::variant<std::monostate, std::uint8_t, std::uint16_t, std::uint32_t,
+                                               std::uint64_t, std::int32_t, float, std::string,
+                                               std::vector<std::uint8_t>>;
+
+    class PreparedStatement
+    {
+    public:
+        explicit PreparedStatement(std::uint32_t index) : m_index(index) {}
+
+        auto index() const { return m_index; }
+        const auto &parameters() const { return m_parameters; }
+
+        void set_null(std::uint16_t index) { set(index, std::monostate{}); }
+        void set_uint8(std::uint16_t index, std::uint8_t value) { set(index, value); }
+        void set_uint16(std::uint16_t index, std::uint16_t value) { set(index, value); }
+        void set_uint32(std::uint16_t index, std::uint32_t value) { set(index, value); }
+        void set_uint64(std::uint16_t index, std::uint64_t value) { set(index, value); }
+        void set_int32(std::uint16_t index, std::int32_t value) { set(index, value); }
+        void set_float(std::uint16_t index, float value) { set(index, value); }
+        void set_string(std::uint16_t index, std::string value) { set(index, std::move(value)); }
+        void set_binary(std::uint16_t index, std::vector<std::uint8_t> value) { set(index, std::move(value)); }
+
+        void set(std::uint16_t index, PreparedStatementData value)
+        {
+            if (index >= m_parameters.size())
+                m_parameters.resize(index + 1);
+            m_parameters[index] = std::move(value);
+        }
+
+    private:
+        std::uint32_t m_index;
+        std::vector<PreparedStatementData> m_parameters;
+    };
+} // namespace Database
@@ -0,0 +1,102 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Database/QueryStatistics.hpp>
+#include <algorithm>
+#include <bit>
+
+namespace Database
+{
+    void QueryStatistics::record(const std::string &type, std::chrono::steady_clock::duration latency)
+    {
+        auto microseconds =
+            std::uint64_t(std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto &histogram = m_histograms[type];
+        histogram.buckets[bucket_index(microseconds)]++;
+        histogram.count++;
+        histogram.max = std::max(histogram.max, microseconds);
+    }
+
+    QueryStatistics::Summary QueryStatistics::summary(const std::string &type) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto histogram = m_histograms.find(type);
+        if (histogram == m_histograms.end())
+            return {};
+        return summarize(histogram->second);
+    }
+
+    std::vector<std::pair<std::string, QueryStatistics::Summary>> QueryStatistics::summaries() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        std::vector<std::pair<std::string, Summary>> result;
+        for (const auto &[type, histogram] : m_histograms)
+            result.emplace_back(type, summarize(histogram));
+        return result;
+    }
+
+    std::uint64_t QueryStatistics::Histogram::percentile(double fraction) const
+    {
+        if (!count)
+            return 0;
+
+        auto target = std::uint64_t(fraction * double(count));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; i++)
+        {
+            seen += buckets[i];
+            if (seen > target)
+                return std::min(bucket_upper_bound(i), max);
+        }
+        return max;
+    }
+
+    std::size_t QueryStatistics::bucket_index(std::uint64_t microseconds)
+    {
+        if (microseconds < 4)
+            return microseconds;
+
+        auto exponent = std::size_t(std::bit_width(microseconds) - 1);
+        auto mantissa = (microseconds >> (exponent - 2)) & 3;
+        return std::min(bucket_count - 1, 4 * (exponent - 1) + mantissa);
+    }
+
+    std::uint64_t QueryStatistics::bucket_upper_bound(std::size_t index)
+    {
+        // The first four buckets hold a single value each
+        if (index < 4)
+            return index;
+
+        auto next = index + 1;
+        auto exponent = next / 4 + 1;
+        auto mantissa = next % 4;
+        return ((4 + mantissa) << (exponent - 2)) - 1;
+    }
+
+    QueryStatistics::Summary QueryStatistics::summarize(const Histogram &histogram)
+    {
+        Summary summary;
+        summary.count = histogram.count;
+        summary.p50 = histogram.percentile(0.50);
+        summary.p95 = histogram.percentile(0.95);
+        summary.p99 = histogram.percentile(0.99);
+        summary.max = histogram.max;
+        return summary;
+    }
+} // namespace Database
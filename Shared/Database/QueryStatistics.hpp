@@ -0,0 +1,66 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Database
+{
+    class QueryStatistics
+    {
+    public:
+        // Latencies are reported in microseconds.
+        struct Summary
+        {
+            std::uint64_t count{0};
+            std::uint64_t p50{0};
+            std::uint64_t p95{0};
+            std::uint64_t p99{0};
+            std::uint64_t max{0};
+        };
+
+        void record(const std::string &type, std::chrono::steady_clock::duration latency);
+        Summary summary(const std::string &type) const;
+        std::vector<std::pair<std::string, Summary>> summaries() const;
+
+    private:
+        static constexpr std::size_t bucket_count = 160;
+
+        struct Histogram
+        {
+            std::array<std::uint64_t, bucket_count> buckets{};
+            std::uint64_t count{0};
+            std::uint64_t max{0};
+
+            std::uint64_t percentile(double fraction) const;
+        };
+
+        mutable std::mutex m_lock;
+        std::map<std::string, Histogram> m_histograms;
+
+        static std::size_t bucket_index(std::uint64_t microseconds);
+        static std::uint64_t bucket_upper_bound(std::size_t index);
+        static Summary summarize(const Histogram &histogram);
+    };
+} // namespace Database
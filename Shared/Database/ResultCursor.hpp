@@ -0,0 +1,54 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Database/ColumnBatch.hpp>
+#include <Database/ConnectionPool.hpp>
+#include <Database/ResultSet.hpp>
+#include <memory>
+
+namespace Database
+{
+    class ResultCursor
+    {
+    public:
+        ResultCursor(ConnectionPool::Handle &&connection, std::unique_ptr<ResultSet> result)
+            : m_connection(std::move(connection)), m_result(std::move(result))
+        {
+        }
+
+        ResultCursor(const ResultCursor &) = delete;
+        ResultCursor &operator=(const ResultCursor &) = delete;
+
+        const auto &metadata() const { return m_result->metadata(); }
+        bool failed() const { return m_result->failed(); }
+        Field *fetch() { return m_result->fetch(); }
+        bool next_row() { return m_result->next_row(); }
+        std::size_t fetch_batch(ColumnBatch &batch, std::size_t max_rows)
+        {
+            return m_result->fetch_batch(batch, max_rows);
+        }
+
+        const Field &operator[](std::size_t index) const { return (*m_result)[index]; }
+
+    private:
+        // The connection stays checked out until the unread rows are drained when the result is freed
+        ConnectionPool::Handle m_connection;
+        std::unique_ptr<ResultSet> m_result;
+    };
+} // namespace Database
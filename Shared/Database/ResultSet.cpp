@@ -20,8 +20,10 @@
 
 namespace Database
 {
-    ResultSet::ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, std::uint64_t row_count, std::uint32_t field_count)
-        : m_result(result), m_fields(fields), m_row_count(row_count), m_field_count(field_count)
+    ResultSet::ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, std::uint64_t row_count, std::uint32_t field_count,
+                         MYSQL *stream_handler)
+        : m_result(result), m_stream_handler(stream_handler), m_fields(fields), m_row_count(row_count),
+          m_field_count(field_count)
     {
         m_field_data.resize(m_field_count);
         m_current_row = new Field[m_field_count];
@@ -160,6 +162,12 @@ namespace Database
         auto row = mysql_fetch_row(m_result);
         if (!row)
         {
+            // Streamed results report a lost connection the same way as the end of the rows
+            if (m_stream_handler && mysql_errno(m_stream_handler))
+            {
+                LOG_ERROR("Failed to stream row, error = {}", mysql_error(m_stream_handler));
+                m_failed = true;
+            }
             clear();
             return false;
         }
@@ -168,6 +176,7 @@ namespace Database
         if (!lengths)
         {
             LOG_ERROR("Failed to retrive lengths value, error = {}", mysql_error(m_result->handle));
+            m_failed = true;
             clear();
             return false;
         }
@@ -178,6 +187,23 @@ namespace Database
         return true;
     }
 
+    std::size_t ResultSet::fetch_batch(ColumnBatch &batch, std::size_t max_rows)
+    {
+        batch.reset(m_field_data);
+        while (m_current_row && batch.row_count() < max_rows)
+        {
+            for (std::uint32_t i = 0; i < m_field_count; i++)
+                batch.append(i, m_current_row[i].m_data.value, m_current_row[i].m_data.length);
+            batch.complete_row();
+
+            if (!next_row())
+                break;
+        }
+
+        batch.finalize();
+        return batch.row_count();
+    }
+
     const Field &ResultSet::operator[](std::size_t index) const
     {
         assert(index < m_field_count);
@@ -17,6 +17,7 @@
  */
 #pragma once
 
+#include <Database/ColumnBatch.hpp>
 #include <Database/Field.hpp>
 #include <Database/QueryResultField.hpp>
 #include <mysql/mysql.h>
@@ -29,26 +30,34 @@ namespace Database
     public:
         ResultSet(ResultSet const &right) = delete;
         ResultSet &operator=(ResultSet const &right) = delete;
-        ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, std::uint64_t row_count, std::uint32_t field_count);
+        ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, std::uint64_t row_count, std::uint32_t field_count,
+                  MYSQL *stream_handler = nullptr);
         ~ResultSet();
 
         auto row_count() { return m_row_count; }
+        const auto &metadata() const { return m_field_data; }
+        // Set when a row could not be read, which a streamed result otherwise reports like its end
+        bool failed() const { return m_failed; }
 
         Field *fetch();
         bool next_row();
+        std::size_t fetch_batch(ColumnBatch &batch, std::size_t max_rows);
 
         const Field &operator[](std::size_t index) const;
 
+        static DatabaseFieldTypes mysql_type_to_field_type(enum_field_types type);
+        static const char *field_type_string(enum_field_types type);
+
     private:
         MYSQL_RES *m_result;
+        MYSQL *m_stream_handler;
         MYSQL_FIELD *m_fields;
         Field *m_current_row;
         std::uint32_t m_field_count;
         std::uint64_t m_row_count;
         std::vector<QueryResultField> m_field_data;
+        bool m_failed{false};
 
         void clear();
-        DatabaseFieldTypes mysql_type_to_field_type(enum_field_types type);
-        const char *field_type_string(enum_field_types type);
     };
 } // namespace Database
@@ -0,0 +1,209 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Database/ConnectionPool.hpp>
+#include <Database/PreparedResultSet.hpp>
+#include <Database/PreparedStatement.hpp>
+#include <Database/ResultCursor.hpp>
+#include <Utilities/Log.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Database
+{
+    template <typename T> struct ColumnTraits;
+
+    template <> struct ColumnTraits<std::uint8_t>
+    {
+        static bool accepts(DatabaseFieldTypes type) { return type == DatabaseFieldTypes::Int8; }
+        static std::uint8_t read(const Field &field) { return field.get_uint8(); }
+    };
+
+    template <> struct ColumnTraits<std::uint16_t>
+    {
+        static bool accepts(DatabaseFieldTypes type)
+        {
+            return type == DatabaseFieldTypes::Int8 || type == DatabaseFieldTypes::Int16;
+        }
+        static std::uint16_t read(const Field &field) { return field.get_uint16(); }
+    };
+
+    template <> struct ColumnTraits<std::uint32_t>
+    {
+        static bool accepts(DatabaseFieldTypes type)
+        {
+            return type == DatabaseFieldTypes::Int8 || type == DatabaseFieldTypes::Int16 ||
+                   type == DatabaseFieldTypes::Int32;
+        }
+        static std::uint32_t read(const Field &field) { return field.get_uint32(); }
+    };
+
+    template <> struct ColumnTraits<std::uint64_t>
+    {
+        static bool accepts(DatabaseFieldTypes type)
+        {
+            return type == DatabaseFieldTypes::Int8 || type == DatabaseFieldTypes::Int16 ||
+                   type == DatabaseFieldTypes::Int32 || type == DatabaseFieldTypes::Int64;
+        }
+        static std::uint64_t read(const Field &field) { return field.get_uint64(); }
+    };
+
+    template <> struct ColumnTraits<float>
+    {
+        static bool accepts(DatabaseFieldTypes type)
+        {
+            return type == DatabaseFieldTypes::Float || type == DatabaseFieldTypes::Double ||
+                   type == DatabaseFieldTypes::Decimal;
+        }
+        static float read(const Field &field) { return field.get_float(); }
+    };
+
+    template <> struct ColumnTraits<std::string>
+    {
+        static bool accepts(DatabaseFieldTypes type)
+        {
+            return type == DatabaseFieldTypes::Binary || type == DatabaseFieldTypes::Decimal ||
+                   type == DatabaseFieldTypes::Date;
+        }
+        static std::string read(const Field &field) { return field.get_string(); }
+    };
+
+    template <std::size_t Size> struct ColumnTraits<std::array<std::uint8_t, Size>>
+    {
+        static bool accepts(DatabaseFieldTypes type) { return type == DatabaseFieldTypes::Binary; }
+        static std::array<std::uint8_t, Size> read(const Field &field)
+        {
+            if (field.is_null() || field.length() != Size)
+                return {};
+            return field.get_binary<Size>();
+        }
+    };
+
+    template <typename Row, typename... Types> class RowLoader
+    {
+    public:
+        explicit RowLoader(Types Row::*...members) : m_members(members...) {}
+
+        // An empty result loads no rows and succeeds, only a query that failed reports false
+        bool load(ConnectionPool &pool, const PreparedStatement &statement, std::vector<Row> &rows) const
+        {
+            bool failed = false;
+            std::unique_ptr<PreparedResultSet> result(pool.query(statement, &failed));
+            if (!result)
+                return !failed;
+            return load(*result, rows);
+        }
+
+        bool load(PreparedResultSet &result, std::vector<Row> &rows) const
+        {
+            if (!check(result.metadata()))
+                return false;
+
+            rows.reserve(rows.size() + result.row_count());
+            do
+            {
+                assign(rows.emplace_back(), result.fetch(), std::index_sequence_for<Types...>{});
+            } while (result.next_row());
+            return true;
+        }
+
+        // Streams the rows instead of buffering the whole result, converting them a column at a time through one
+        // batch reused for every fetch
+        bool load(ConnectionPool &pool, const PreparedStatement &statement, std::vector<Row> &rows,
+                  std::size_t batch_rows) const
+        {
+            bool failed = false;
+            auto cursor = pool.stream(statement, &failed);
+            if (!cursor)
+                return !failed;
+            return load(*cursor, rows, batch_rows);
+        }
+
+        bool load(ResultCursor &cursor, std::vector<Row> &rows, std::size_t batch_rows) const
+        {
+            if (!check(cursor.metadata()))
+                return false;
+
+            ColumnBatch batch;
+            while (auto count = cursor.fetch_batch(batch, batch_rows))
+            {
+                auto first = rows.size();
+                rows.resize(first + count);
+                assign(rows, first, batch, std::index_sequence_for<Types...>{});
+            }
+            return !cursor.failed();
+        }
+
+    private:
+        std::tuple<Types Row::*...> m_members;
+
+        // Column types are validated once per result so the per row path is only raw reads
+        bool check(const std::vector<QueryResultField> &metadata) const
+        {
+            if (metadata.size() != sizeof...(Types))
+            {
+                LOG_ERROR("Column count mismatch, expected = {}, received = {}", sizeof...(Types), metadata.size());
+                return false;
+            }
+            return check(metadata, std::index_sequence_for<Types...>{});
+        }
+
+        template <std::size_t... Indexes>
+        bool check(const std::vector<QueryResultField> &metadata, std::index_sequence<Indexes...>) const
+        {
+            return (check_column<Types>(metadata[Indexes]) && ...);
+        }
+
+        template <typename T> static bool check_column(const QueryResultField &metadata)
+        {
+            if (ColumnTraits<T>::accepts(metadata.type))
+                return true;
+
+            LOG_ERROR("Column type mismatch, column = {}, name = {}, type = {}", metadata.index,
+                      metadata.alias ? metadata.alias : "", metadata.type_name);
+            return false;
+        }
+
+        template <std::size_t... Indexes>
+        void assign(Row &row, const Field *fields, std::index_sequence<Indexes...>) const
+        {
+            ((row.*std::get<Indexes>(m_members) = ColumnTraits<Types>::read(fields[Indexes])), ...);
+        }
+
+        template <std::size_t... Indexes>
+        void assign(std::vector<Row> &rows, std::size_t first, const ColumnBatch &batch,
+                    std::index_sequence<Indexes...>) const
+        {
+            (assign_column<Indexes, Types>(rows, first, batch.column(Indexes)), ...);
+        }
+
+        template <std::size_t Index, typename T>
+        void assign_column(std::vector<Row> &rows, std::size_t first, const std::vector<Field> &column) const
+        {
+            auto member = std::get<Index>(m_members);
+            for (std::size_t row = 0; row < column.size(); row++)
+                rows[first + row].*member = ColumnTraits<T>::read(column[row]);
+        }
+    };
+} // namespace Database
@@ -0,0 +1,264 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Database/WriteBehindQueue.hpp>
+#include <Utilities/Log.hpp>
+#include <algorithm>
+
+namespace Database
+{
+    WriteBehindQueue::WriteBehindQueue(ConnectionPool &pool, const Options &options)
+        : m_pool(pool), m_options(options), m_thread(&WriteBehindQueue::run, this)
+    {
+    }
+
+    WriteBehindQueue::~WriteBehindQueue() { stop(); }
+
+    std::optional<std::uint32_t> WriteBehindQueue::register_batch(const Batch &batch)
+    {
+        BatchStatements statements{batch.table, batch.key_columns.size(), {}, 0, {}};
+        for (const auto &[column, expression] : batch.assignments)
+        {
+            statements.value_counts.push_back(std::count(expression.begin(), expression.end(), '?'));
+            statements.value_count += statements.value_counts.back();
+        }
+
+        for (std::size_t i = 0; i < chunk_rows.size(); i++)
+        {
+            auto name = fmt::format("{}_write_behind_{}", batch.table, chunk_rows[i]);
+            auto index = m_pool.add_statement(std::move(name), build_sql(batch, chunk_rows[i]));
+            if (!index)
+                return std::nullopt;
+            statements.statements[i] = *index;
+        }
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_batches.push_back(std::move(statements));
+        m_pending.emplace_back();
+        return static_cast<std::uint32_t>(m_batches.size() - 1);
+    }
+
+    bool WriteBehindQueue::update(std::uint32_t batch, Key key, Values values)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_stopped || batch >= m_batches.size())
+                return false;
+
+            const auto &definition = m_batches[batch];
+            if (key.size() != definition.key_count || values.size() != definition.value_count)
+            {
+                LOG_ERROR("Write behind update does not match batch, table = {}", definition.table);
+                return false;
+            }
+
+            auto &pending = m_pending[batch];
+            if (auto it = pending.find(key); it != pending.end())
+            {
+                it->second = std::move(values);
+                m_statistics.updates++;
+                m_statistics.coalesced++;
+                return true;
+            }
+
+            // Refuse new keys once full so producers on network threads never block on the database
+            if (m_pending_count >= m_options.max_pending)
+            {
+                m_statistics.rejected++;
+                return false;
+            }
+
+            pending.emplace(std::move(key), std::move(values));
+            m_pending_count++;
+            m_statistics.updates++;
+            if (m_pending_count < m_options.flush_threshold)
+                return true;
+        }
+
+        m_condition.notify_one();
+        return true;
+    }
+
+    bool WriteBehindQueue::flush()
+    {
+        std::lock_guard<std::mutex> flush_lock(m_flush_lock);
+
+        // Batches may be registered while the flush thread runs, so their definitions are read with the pending rows
+        std::vector<BatchStatements> batches;
+        auto pending = take_pending(batches);
+        std::size_t row_count = 0;
+        for (const auto &rows : pending)
+            row_count += rows.size();
+
+        if (!row_count)
+            return true;
+
+        auto connection = m_pool.checkout();
+        if (!connection)
+        {
+            restore_pending(std::move(pending));
+            return false;
+        }
+
+        std::vector<PreparedStatement> statements;
+        for (std::size_t batch = 0; batch < pending.size(); batch++)
+            build_statements(batches[batch], pending[batch], statements);
+
+        if (!connection->transaction(statements))
+        {
+            LOG_ERROR("Failed to flush {} queued writes, keeping them for the next flush", row_count);
+            restore_pending(std::move(pending));
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_statistics.flushes++;
+        m_statistics.rows_written += row_count;
+        return true;
+    }
+
+    void WriteBehindQueue::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_stopped)
+                return;
+            m_stopped = true;
+        }
+        m_condition.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+
+        if (!flush())
+            LOG_ERROR("Failed to flush queued writes on shutdown, pending = {}", statistics().pending);
+    }
+
+    WriteBehindQueue::Statistics WriteBehindQueue::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto statistics = m_statistics;
+        statistics.pending = m_pending_count;
+        return statistics;
+    }
+
+    void WriteBehindQueue::run()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_condition.wait_for(lock, m_options.flush_interval, [this]() {
+                    return m_stopped || m_pending_count >= m_options.flush_threshold;
+                });
+                if (m_stopped)
+                    return;
+            }
+            flush();
+        }
+    }
+
+    std::vector<WriteBehindQueue::Pending> WriteBehindQueue::take_pending(std::vector<BatchStatements> &batches)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        batches = m_batches;
+        std::vector<Pending> pending(m_pending.size());
+        pending.swap(m_pending);
+        m_pending_count = 0;
+        return pending;
+    }
+
+    void WriteBehindQueue::restore_pending(std::vector<Pending> &&failed)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_statistics.failures++;
+        for (std::size_t batch = 0; batch < failed.size(); batch++)
+        {
+            // Values queued while the flush was running are newer, so they win over the failed ones
+            for (auto &[key, values] : failed[batch])
+            {
+                if (m_pending[batch].emplace(key, std::move(values)).second)
+                    m_pending_count++;
+            }
+        }
+    }
+
+    std::string WriteBehindQueue::build_sql(const Batch &batch, std::size_t rows)
+    {
+        // UPDATE table SET column = CASE WHEN key = ? THEN expression ... ELSE column END WHERE (key) IN ((?), ...)
+        std::string row_match;
+        for (std::size_t k = 0; k < batch.key_columns.size(); k++)
+            row_match += (k ? " AND " : "") + batch.key_columns[k] + " = ?";
+
+        std::string sql = "UPDATE " + batch.table + " SET ";
+        for (std::size_t i = 0; i < batch.assignments.size(); i++)
+        {
+            const auto &[column, expression] = batch.assignments[i];
+            sql += (i ? ", " : "") + column + " = CASE";
+            for (std::size_t row = 0; row < rows; row++)
+                sql += " WHEN " + row_match + " THEN " + expression;
+            sql += " ELSE " + column + " END";
+        }
+
+        std::string row_key = "(";
+        for (std::size_t k = 0; k < batch.key_columns.size(); k++)
+            row_key += (k ? ", " : "") + std::string("?");
+        row_key += ")";
+
+        sql += " WHERE (";
+        for (std::size_t k = 0; k < batch.key_columns.size(); k++)
+            sql += (k ? ", " : "") + batch.key_columns[k];
+        sql += ") IN (";
+        for (std::size_t row = 0; row < rows; row++)
+            sql += (row ? ", " : "") + row_key;
+        return sql + ")";
+    }
+
+    void WriteBehindQueue::build_statements(const BatchStatements &batch, const Pending &pending,
+                                            std::vector<PreparedStatement> &statements)
+    {
+        // Parameters follow the sql: per assignment the key and values of every row, then every key of the IN list
+        auto it = pending.begin();
+        auto remaining = pending.size();
+        for (std::size_t size = 0; size < chunk_rows.size(); size++)
+        {
+            for (; remaining >= chunk_rows[size]; remaining -= chunk_rows[size])
+            {
+                auto end = std::next(it, std::ptrdiff_t(chunk_rows[size]));
+                auto &statement = statements.emplace_back(batch.statements[size]);
+                std::uint16_t index = 0;
+                for (std::size_t i = 0, offset = 0; i < batch.value_counts.size(); offset += batch.value_counts[i++])
+                {
+                    for (auto row = it; row != end; ++row)
+                    {
+                        for (auto column : row->first)
+                            statement.set_uint32(index++, column);
+                        for (std::size_t value = 0; value < batch.value_counts[i]; value++)
+                            statement.set(index++, row->second[offset + value]);
+                    }
+                }
+
+                for (auto row = it; row != end; ++row)
+                {
+                    for (auto column : row->first)
+                        statement.set_uint32(index++, column);
+                }
+                it = end;
+            }
+        }
+    }
+} // namespace Database
@@ -0,0 +1,119 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Database/ConnectionPool.hpp>
+#include <Database/PreparedStatement.hpp>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Database
+{
+    class WriteBehindQueue
+    {
+    public:
+        using Key = std::vector<std::uint32_t>;
+        using Values = std::vector<PreparedStatementData>;
+
+        struct Batch
+        {
+            std::string table;
+            std::vector<std::string> key_columns;
+            // Column and expression pairs, each ? in the expression binds the next queued value
+            std::vector<std::pair<std::string, std::string>> assignments;
+        };
+
+        struct Options
+        {
+            std::chrono::milliseconds flush_interval{1000};
+            std::size_t flush_threshold{256};
+            std::size_t max_pending{4096};
+        };
+
+        struct Statistics
+        {
+            std::uint64_t updates{0};
+            std::uint64_t coalesced{0};
+            std::uint64_t rejected{0};
+            std::uint64_t flushes{0};
+            std::uint64_t rows_written{0};
+            std::uint64_t failures{0};
+            std::size_t pending{0};
+        };
+
+        WriteBehindQueue(ConnectionPool &pool, const Options &options);
+        explicit WriteBehindQueue(ConnectionPool &pool) : WriteBehindQueue(pool, Options{}) {}
+        WriteBehindQueue(const WriteBehindQueue &) = delete;
+        WriteBehindQueue &operator=(const WriteBehindQueue &) = delete;
+        ~WriteBehindQueue();
+
+        // Adds the statements of the batch to the pool, which only takes them before it opens
+        std::optional<std::uint32_t> register_batch(const Batch &batch);
+        bool update(std::uint32_t batch, Key key, Values values);
+        bool flush();
+        void stop();
+
+        Statistics statistics() const;
+
+    private:
+        using Pending = std::map<Key, Values>;
+
+        // Rows are written in chunks of these sizes, each a multi-row UPDATE prepared once per connection. A flush
+        // takes a round trip per chunk instead of per row, and a batch needs only as many statements as sizes
+        static constexpr std::array<std::size_t, 4> chunk_rows{64, 16, 4, 1};
+
+        struct BatchStatements
+        {
+            std::string table;
+            std::size_t key_count;
+            // Queued values taken by each assignment, in order
+            std::vector<std::size_t> value_counts;
+            std::size_t value_count;
+            std::array<std::uint32_t, chunk_rows.size()> statements;
+        };
+
+        ConnectionPool &m_pool;
+        Options m_options;
+
+        mutable std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::mutex m_flush_lock;
+        std::vector<BatchStatements> m_batches;
+        std::vector<Pending> m_pending;
+        std::size_t m_pending_count{0};
+        Statistics m_statistics;
+        bool m_stopped{false};
+        std::thread m_thread;
+
+        void run();
+        std::vector<Pending> take_pending(std::vector<BatchStatements> &batches);
+        void restore_pending(std::vector<Pending> &&failed);
+        static std::string build_sql(const Batch &batch, std::size_t rows);
+        static void build_statements(const BatchStatements &batch, const Pending &pending,
+                                     std::vector<PreparedStatement> &statements);
+    };
+} // namespace Database
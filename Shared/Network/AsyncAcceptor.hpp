@@ -20,19 +20,42 @@
 #include <atomic>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <utility>
 
+#ifdef __linux__
+#include <netinet/tcp.h>
+#endif
+
 namespace Network
 {
+    struct AcceptorOptions
+    {
+        bool reuse_port{false};
+        int backlog{boost::asio::socket_base::max_listen_connections};
+        std::size_t accept_batch_size{32};
+    };
+
+    struct AcceptStatistics
+    {
+        std::uint64_t accepted{0};
+        std::uint64_t wakeups{0};
+        std::size_t largest_batch{0};
+        double accept_rate{0.0};
+        std::uint32_t backlog_depth{0};
+        std::uint32_t backlog_limit{0};
+    };
+
     class AsyncAcceptor
     {
     public:
         typedef void (*AcceptCallback)(boost::asio::ip::tcp::socket &&socket, std::uint32_t);
 
-        AsyncAcceptor(boost::asio::io_context &io_context, const std::string &ip, int port)
-            : m_acceptor(io_context), m_endpoint(boost::asio::ip::make_address(ip), port)
+        AsyncAcceptor(boost::asio::io_context &io_context, const std::string &ip, int port,
+                      const AcceptorOptions &options = {})
+            : m_acceptor(io_context), m_endpoint(boost::asio::ip::make_address(ip), port), m_options(options)
         {
         }
 
@@ -53,6 +76,21 @@ namespace Network
                 return false;
             }
 
+            if (m_options.reuse_port)
+            {
+#ifdef SO_REUSEPORT
+                using ReusePort = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+                m_acceptor.set_option(ReusePort(true), code);
+#else
+                code = boost::asio::error::operation_not_supported;
+#endif
+                if (code)
+                {
+                    std::cerr << "Failed to set acceptor::reuse_port - " << code.message().c_str() << std::endl;
+                    return false;
+                }
+            }
+
             m_acceptor.bind(m_endpoint, code);
             if (code)
             {
@@ -60,13 +98,21 @@ namespace Network
                 return false;
             }
 
-            m_acceptor.listen(boost::asio::socket_base::max_listen_connections, code);
+            m_acceptor.listen(m_options.backlog, code);
             if (code)
             {
                 std::cerr << "Failed start listening - " << code.message().c_str() << std::endl;
                 return false;
             }
 
+            m_acceptor.non_blocking(true, code);
+            if (code)
+            {
+                std::cerr << "Failed to set acceptor::non_blocking - " << code.message().c_str() << std::endl;
+                return false;
+            }
+
+            m_rate_window_start = std::chrono::steady_clock::now();
             return true;
         }
 
@@ -78,15 +124,8 @@ namespace Network
             m_acceptor.async_accept(*socket, [this, socket, index](boost::system::error_code error) {
                 if (!error)
                 {
-                    try
-                    {
-                        socket->non_blocking(true);
-                        accept_callback(std::move(*socket), index);
-                    }
-                    catch (const boost::system::system_error &e)
-                    {
-                        std::cerr << "Failed to initialize socket - " << e.what() << std::endl;
-                    }
+                    open_socket<accept_callback>(*socket, index);
+                    drain_backlog<accept_callback>();
                 }
 
                 if (!m_closed)
@@ -94,6 +133,30 @@ namespace Network
             });
         }
 
+        AcceptStatistics statistics() const
+        {
+            AcceptStatistics statistics;
+            statistics.accepted = m_accepted;
+            statistics.wakeups = m_wakeups;
+            statistics.largest_batch = m_largest_batch;
+            statistics.accept_rate = m_accept_rate;
+
+#ifdef __linux__
+            tcp_info info{};
+            socklen_t length = sizeof(info);
+            auto handle = const_cast<boost::asio::ip::tcp::acceptor &>(m_acceptor).native_handle();
+            // On a listening socket tcp_get_info reuses these fields: tcpi_unacked holds sk_ack_backlog, connections
+            // established and waiting in the accept queue, and tcpi_sacked holds sk_max_ack_backlog, the listen
+            // backlog the kernel capped at net.core.somaxconn. Half open connections in SYN_RECV are not counted
+            if (getsockopt(handle, IPPROTO_TCP, TCP_INFO, &info, &length) == 0)
+            {
+                statistics.backlog_depth = info.tcpi_unacked;
+                statistics.backlog_limit = info.tcpi_sacked;
+            }
+#endif
+            return statistics;
+        }
+
         void set_socket_factory(std::function<std::pair<boost::asio::ip::tcp::socket *, std::uint32_t>()> func)
         {
             m_socket_factory = std::move(func);
@@ -103,6 +166,61 @@ namespace Network
         std::atomic<bool> m_closed{false};
         boost::asio::ip::tcp::acceptor m_acceptor;
         boost::asio::ip::tcp::endpoint m_endpoint;
+        AcceptorOptions m_options;
         std::function<std::pair<boost::asio::ip::tcp::socket *, std::uint32_t>()> m_socket_factory;
+        std::atomic<std::uint64_t> m_accepted{0};
+        std::atomic<std::uint64_t> m_wakeups{0};
+        std::atomic<std::size_t> m_largest_batch{0};
+        std::atomic<double> m_accept_rate{0.0};
+        std::uint64_t m_rate_window_accepted{0};
+        std::chrono::steady_clock::time_point m_rate_window_start;
+
+        template <AcceptCallback accept_callback>
+        void open_socket(boost::asio::ip::tcp::socket &socket, std::uint32_t index)
+        {
+            try
+            {
+                socket.non_blocking(true);
+                accept_callback(std::move(socket), index);
+            }
+            catch (const boost::system::system_error &e)
+            {
+                std::cerr << "Failed to initialize socket - " << e.what() << std::endl;
+            }
+        }
+
+        template <AcceptCallback accept_callback> void drain_backlog()
+        {
+            std::size_t batch = 1;
+            while (batch < m_options.accept_batch_size && !m_closed)
+            {
+                boost::asio::ip::tcp::socket *socket;
+                std::uint32_t index;
+                std::tie(socket, index) = m_socket_factory();
+
+                boost::system::error_code error;
+                m_acceptor.accept(*socket, error);
+                if (error)
+                    break;
+
+                open_socket<accept_callback>(*socket, index);
+                batch++;
+            }
+
+            m_wakeups++;
+            m_accepted += batch;
+            if (batch > m_largest_batch)
+                m_largest_batch = batch;
+
+            m_rate_window_accepted += batch;
+            auto now = std::chrono::steady_clock::now();
+            auto elapsed = std::chrono::duration<double>(now - m_rate_window_start).count();
+            if (elapsed >= 1.0)
+            {
+                m_accept_rate = double(m_rate_window_accepted) / elapsed;
+                m_rate_window_accepted = 0;
+                m_rate_window_start = now;
+            }
+        }
     };
 } // namespace Network
@@ -17,30 +17,107 @@
  */
 #pragma once
 
+#include <Utilities/Log.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <chrono>
+#include <charconv>
+#include <functional>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace Network
 {
+    // Resolves host names without blocking the io_context. Literal addresses never reach the system resolver,
+    // answers are cached for time_to_live and the last good answer of a host is handed out when a later lookup
+    // fails. Lookups of a host already in flight wait for that lookup instead of starting another one. Not thread
+    // safe, every call and every handler runs on the io_context
     class Resolver
     {
     public:
-        explicit Resolver(boost::asio::io_context &io_context) : m_resolver(io_context) {}
+        using Endpoint = boost::asio::ip::tcp::endpoint;
+        using Handler = std::function<void(std::optional<Endpoint>)>;
 
-        std::optional<boost::asio::ip::tcp::endpoint> resolve(const boost::asio::ip::tcp &protocol,
-                                                              const std::string &host, const std::string &service)
+        explicit Resolver(boost::asio::io_context &io_context,
+                          std::chrono::seconds time_to_live = std::chrono::seconds(300))
+            : m_resolver(io_context), m_time_to_live(time_to_live)
         {
+        }
+
+        // The handler is always posted, never invoked from inside this call
+        void async_resolve(const boost::asio::ip::tcp &protocol, const std::string &host, const std::string &service,
+                           Handler handler)
+        {
+            auto executor = m_resolver.get_executor();
             boost::system::error_code error;
+            auto address = boost::asio::ip::make_address(host, error);
+            std::uint16_t port = 0;
+            auto [end, result] = std::from_chars(service.data(), service.data() + service.size(), port);
+            if (!error && (service.empty() || (result == std::errc() && end == service.data() + service.size())))
+            {
+                std::optional<Endpoint> endpoint;
+                if (address.is_v4() == (protocol == boost::asio::ip::tcp::v4()))
+                    endpoint = Endpoint(address, port);
+                boost::asio::post(executor, [handler = std::move(handler), endpoint] { handler(endpoint); });
+                return;
+            }
+
+            auto key = std::to_string(protocol.family()) + '/' + host + '/' + service;
+            auto cached = m_cache.find(key);
+            if (cached != m_cache.end() && cached->second.expires > std::chrono::steady_clock::now())
+            {
+                auto endpoint = cached->second.endpoint;
+                boost::asio::post(executor, [handler = std::move(handler), endpoint] { handler(endpoint); });
+                return;
+            }
+
+            auto &waiting = m_pending[key];
+            waiting.push_back(std::move(handler));
+            if (waiting.size() > 1)
+                return;
+
             boost::asio::ip::resolver_base::flags flags = boost::asio::ip::resolver_base::all_matching;
-            boost::asio::ip::tcp::resolver::results_type results =
-                m_resolver.resolve(protocol, host, service, flags, error);
-            if (results.begin() == results.end() || error)
-                return {};
-            return results.begin()->endpoint();
+            m_resolver.async_resolve(protocol, host, service, flags,
+                                     [this, key, host](const boost::system::error_code &error,
+                                                       boost::asio::ip::tcp::resolver::results_type results) {
+                                         complete(key, host, error, results);
+                                     });
         }
 
     private:
+        struct CacheEntry
+        {
+            Endpoint endpoint;
+            std::chrono::steady_clock::time_point expires;
+        };
+
         boost::asio::ip::tcp::resolver m_resolver;
+        std::chrono::seconds m_time_to_live;
+        std::unordered_map<std::string, CacheEntry> m_cache;
+        std::unordered_map<std::string, std::vector<Handler>> m_pending;
+
+        void complete(const std::string &key, const std::string &host, const boost::system::error_code &error,
+                      const boost::asio::ip::tcp::resolver::results_type &results)
+        {
+            std::optional<Endpoint> endpoint;
+            if (!error && results.begin() != results.end())
+            {
+                endpoint = results.begin()->endpoint();
+                m_cache[key] = {*endpoint, std::chrono::steady_clock::now() + m_time_to_live};
+            }
+            else if (auto cached = m_cache.find(key); cached != m_cache.end())
+            {
+                LOG_WARN("Failed to resolve {}, keeping last known address {}", host,
+                         cached->second.endpoint.address().to_string());
+                endpoint = cached->second.endpoint;
+            }
+
+            auto waiting = std::move(m_pending[key]);
+            m_pending.erase(key);
+            for (auto &handler : waiting)
+                handler(endpoint);
+        }
     };
 } // namespace Network
@@ -21,34 +21,63 @@
 #include <Utilities/Log.hpp>
 #include <Utilities/MessageBuffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
-#include <queue>
+#include <vector>
 
 namespace Network
 {
+    struct WriteStatistics
+    {
+        std::uint64_t syscalls{0};
+        std::uint64_t packets{0};
+        std::uint64_t bytes{0};
+
+        double syscalls_per_packet() const { return packets ? double(syscalls) / double(packets) : 0.0; }
+    };
+
     template <class T> class Socket : public std::enable_shared_from_this<T>
     {
     public:
-        Socket(boost::asio::ip::tcp::socket socket) : m_socket(std::move(socket)) {}
+        Socket(boost::asio::ip::tcp::socket socket) : m_socket(std::move(socket))
+        {
+            boost::system::error_code code;
+            m_socket.non_blocking(true, code);
+        }
 
         auto is_open() { return !m_closed && !m_closing; }
 
         void start() { on_start(); }
 
-        virtual bool update()
-        {
-            if (m_closed)
-                return false;
+        virtual bool update() { return !m_closed; }
 
-            if (m_writing_async || (m_write_queue.empty() && !m_closing))
-                return true;
+        auto take_write_statistics() { return std::exchange(m_write_statistics, {}); }
+        auto write_queue_size() const { return m_write_queue.size(); }
+        auto take_busy_time() { return std::exchange(m_busy_time, {}); }
 
-            while (handle_queue())
-                ;
+        virtual bool is_idle()
+        {
+            return is_open() && !m_migrate_target && !m_writing_async && !m_flush_pending && m_write_queue.empty() &&
+                   !m_bound_completions;
+        }
+
+        // Runs on the owning thread. The socket moves at its next read completion, which checks is_idle again since
+        // work may have started in between, and on_migrated then runs on the old thread with the moved socket
+        void migrate(boost::asio::io_context &io_context, std::function<void(std::shared_ptr<T>)> on_migrated)
+        {
+            m_migrate_target = &io_context;
+            m_on_migrated = std::move(on_migrated);
 
-            return true;
+            boost::system::error_code code;
+            m_socket.cancel(code);
         }
 
+        void resume() { async_read(); }
+
         void close_socket()
         {
             if (m_closed.exchange(true))
@@ -59,6 +88,7 @@ namespace Network
             if (code)
                 LOG_ERROR("Error on remote = {}, socket shutdown, code = {}, message = {}",
                           remote_address().to_string(), code.value(), code.message());
+            m_socket.close(code);
         }
 
     protected:
@@ -70,87 +100,198 @@ namespace Network
 
         auto &read_buffer() { return m_read_buffer; }
 
-        void queue_packet(Utilities::MessageBuffer &&packet) { m_write_queue.push(std::move(packet)); }
+        void queue_packet(Utilities::MessageBuffer &&packet)
+        {
+            if (m_closed)
+                return;
+
+            if (!packet.active_size())
+                return;
+
+            m_write_queue.push_back(std::move(packet));
+            if (m_writing_async || m_flush_pending)
+                return;
+
+            m_flush_pending = true;
+            boost::asio::post(m_socket.get_executor(), [this, self = this->shared_from_this()]() {
+                m_flush_pending = false;
+                handle_queue();
+            });
+        }
+
+        void queue_packet(Utilities::ByteBuffer &&packet) { queue_packet(Utilities::MessageBuffer(std::move(packet))); }
+
+        // The completion posts to the executor of the thread owning the socket when it was bound, so the socket is
+        // not idle, and never migrates, until the completion has run there or was destroyed without running
+        template <typename Handler> auto bind_to_socket(Handler handler)
+        {
+            m_bound_completions++;
+            std::shared_ptr<void> bound(nullptr,
+                                        [self = this->shared_from_this()](void *) { self->m_bound_completions--; });
+            return [this, self = this->shared_from_this(), executor = m_socket.get_executor(),
+                    handler = std::move(handler), bound = std::move(bound)](auto result) mutable {
+                boost::asio::post(executor, [this, self, handler, bound = std::move(bound),
+                                             result = std::move(result)]() mutable {
+                    measure_busy([&]() { handler(std::move(result)); });
+                });
+            };
+        }
 
         void async_read()
         {
             if (!is_open())
                 return;
 
+            if (m_migrate_target)
+            {
+                complete_migration();
+                return;
+            }
+
             m_read_buffer.normalize();
             m_read_buffer.ensure_free_space();
             m_socket.async_read_some(boost::asio::buffer(m_read_buffer.write_ptr(), m_read_buffer.remaining_size()),
-                                     [this](boost::system::error_code error, std::size_t bytes) {
+                                     [this, self = this->shared_from_this()](boost::system::error_code error,
+                                                                             std::size_t bytes) {
                                          if (error)
                                          {
-                                             close_socket();
+                                             if (error == boost::asio::error::operation_aborted && m_migrate_target)
+                                                 complete_migration();
+                                             else
+                                                 close_socket();
                                              return;
                                          }
 
                                          m_read_buffer.write_completed(bytes);
-                                         on_read();
+                                         measure_busy([this]() { on_read(); });
                                      });
         }
 
     private:
         std::atomic<bool> m_closed{false};
         std::atomic<bool> m_closing{false};
+        static constexpr std::size_t max_write_buffers = 64;
+
+        // Bound completions may be destroyed on the thread that was handed them
+        std::atomic<std::size_t> m_bound_completions{0};
         bool m_writing_async{false};
+        bool m_flush_pending{false};
         boost::asio::ip::tcp::socket m_socket;
         Utilities::MessageBuffer m_read_buffer;
-        std::queue<Utilities::MessageBuffer> m_write_queue;
+        std::deque<Utilities::MessageBuffer> m_write_queue;
+        std::vector<boost::asio::const_buffer> m_write_buffers;
+        WriteStatistics m_write_statistics;
+        std::chrono::steady_clock::duration m_busy_time{};
+        boost::asio::io_context *m_migrate_target{nullptr};
+        std::function<void(std::shared_ptr<T>)> m_on_migrated;
 
-        bool handle_queue()
+        // Busy time feeds thread balancing, so it covers reads and the completions posted back to the socket
+        template <typename Work> void measure_busy(Work &&work)
         {
-            if (m_write_queue.empty())
-                return false;
-
-            auto &message = m_write_queue.front();
-            auto message_size = message.active_size();
+            auto start = std::chrono::steady_clock::now();
+            work();
+            m_busy_time += std::chrono::steady_clock::now() - start;
+        }
 
-            boost::system::error_code error;
-            auto sent = m_socket.write_some(boost::asio::buffer(message.read_ptr(), message_size), error);
+        void complete_migration()
+        {
+            auto target = std::exchange(m_migrate_target, nullptr);
+            auto on_migrated = std::move(m_on_migrated);
+            if (!is_idle())
+            {
+                async_read();
+                return;
+            }
 
-            if (error)
+            try
             {
-                if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
-                    return handle_queue_async();
-                m_write_queue.pop();
-                if (m_closing && m_write_queue.empty())
-                    close_socket();
-                return false;
+                auto protocol = m_socket.local_endpoint().protocol();
+                auto handle = m_socket.release();
+                m_socket = boost::asio::ip::tcp::socket(*target, protocol, handle);
+                m_socket.non_blocking(true);
             }
-            else if (sent == 0)
+            catch (const boost::system::system_error &e)
             {
-                m_write_queue.pop();
-                if (m_closing && m_write_queue.empty())
-                    close_socket();
-                return false;
+                LOG_ERROR("Failed to migrate socket, error = {}", e.what());
+                close_socket();
+                return;
             }
-            else if (sent < message_size)
+
+            on_migrated(this->shared_from_this());
+        }
+
+        void handle_queue()
+        {
+            if (m_writing_async || m_closed)
+                return;
+
+            while (!m_write_queue.empty())
             {
-                message.read_completed(sent);
-                return handle_queue_async();
+                m_write_buffers.clear();
+                for (auto &message : m_write_queue)
+                {
+                    m_write_buffers.emplace_back(message.read_ptr(), message.active_size());
+                    if (m_write_buffers.size() == max_write_buffers)
+                        break;
+                }
+
+                boost::system::error_code error;
+                auto sent = m_socket.write_some(m_write_buffers, error);
+                m_write_statistics.syscalls++;
+
+                if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
+                {
+                    handle_queue_async();
+                    return;
+                }
+
+                if (error || sent == 0)
+                {
+                    m_write_queue.clear();
+                    close_socket();
+                    return;
+                }
+
+                m_write_statistics.bytes += sent;
+                write_completed(sent);
             }
 
-            m_write_queue.pop();
-            if (m_closing && m_write_queue.empty())
+            if (m_closing)
                 close_socket();
+        }
+
+        void write_completed(std::size_t sent)
+        {
+            while (sent)
+            {
+                auto &message = m_write_queue.front();
+                auto message_size = message.active_size();
+                if (sent < message_size)
+                {
+                    message.read_completed(sent);
+                    return;
+                }
 
-            return !m_write_queue.empty();
+                sent -= message_size;
+                m_write_queue.pop_front();
+                m_write_statistics.packets++;
+            }
         }
 
-        bool handle_queue_async()
+        void handle_queue_async()
         {
-            if (m_writing_async)
-                return false;
             m_writing_async = true;
-
-            m_socket.async_write_some(boost::asio::null_buffers(), [this](auto, auto) {
-                m_writing_async = false;
-                handle_queue();
-            });
-            return false;
+            m_socket.async_wait(boost::asio::socket_base::wait_write,
+                                [this, self = this->shared_from_this()](boost::system::error_code error) {
+                                    m_writing_async = false;
+                                    if (error)
+                                    {
+                                        m_write_queue.clear();
+                                        close_socket();
+                                        return;
+                                    }
+                                    handle_queue();
+                                });
         }
     };
 } // namespace Network
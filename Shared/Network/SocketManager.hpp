@@ -19,82 +19,192 @@
 
 #include <Network/AsyncAcceptor.hpp>
 #include <Network/Thread.hpp>
+#include <Utilities/Log.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <cmath>
+#include <memory>
+#include <vector>
 
 namespace Network
 {
     template <class SocketType> class SocketManager
     {
     public:
-        virtual bool init(boost::asio::io_context &io_context, const std::string &ip, int port, int thread_count)
+        virtual bool init(boost::asio::io_context &io_context, const std::string &ip, int port, int thread_count,
+                          const AcceptorOptions &options = {})
         {
-            AsyncAcceptor *acceptor;
-            try
+            m_thread_count = thread_count;
+            m_threads = create_threads();
+
+            if (options.reuse_port)
             {
-                acceptor = new AsyncAcceptor(io_context, ip, port);
+                for (auto i = 0; i < m_thread_count; i++)
+                {
+                    auto acceptor = create_acceptor(m_threads[i].io_context(), ip, port, options);
+                    if (!acceptor)
+                        return false;
+
+                    auto socket = m_threads[i].get_socket_for_accept();
+                    acceptor->set_socket_factory([socket, i]() { return std::make_pair(socket, std::uint32_t(i)); });
+                    m_acceptors.push_back(acceptor);
+                }
             }
-            catch (const boost::system::system_error &e)
+            else
             {
-                return false;
-            }
+                auto acceptor = create_acceptor(io_context, ip, port, options);
+                if (!acceptor)
+                    return false;
 
-            if (!acceptor->bind())
-            {
-                delete acceptor;
-                return false;
+                acceptor->set_socket_factory([this]() { return get_socket_for_accept(); });
+                m_acceptors.push_back(acceptor);
             }
 
-            m_acceptor = acceptor;
-            m_thread_count = thread_count;
-            m_threads = create_threads();
-
             for (auto i = 0; i < m_thread_count; i++)
                 m_threads[i].start();
 
-            acceptor->set_socket_factory([this]() { return get_socket_for_accept(); });
+            if (m_thread_count > 1)
+            {
+                m_balance_timer = std::make_unique<DeadlineTimer>(io_context);
+                balance(boost::system::error_code());
+            }
 
             return true;
         }
 
         void on_socket_open(boost::asio::ip::tcp::socket &&socket, std::uint32_t index)
         {
-            try
-            {
-                auto new_socket = std::make_shared<SocketType>(std::move(socket));
-                new_socket->start();
-                m_threads[index].append(new_socket);
-            }
-            catch (const boost::system::system_error &e)
-            {
-                std::cerr << "Failed to retrieve client socket - " << e.what() << std::endl;
-            }
+            m_threads[index].append(std::move(socket));
         }
 
     protected:
         auto thread_count() const { return m_thread_count; }
+        auto thread_statistics(int index) const { return m_threads[index].statistics(); }
 
-        AsyncAcceptor *m_acceptor{nullptr};
+        AcceptStatistics accept_statistics() const
+        {
+            AcceptStatistics total;
+            for (auto acceptor : m_acceptors)
+            {
+                auto statistics = acceptor->statistics();
+                total.accepted += statistics.accepted;
+                total.wakeups += statistics.wakeups;
+                total.largest_batch = std::max(total.largest_batch, statistics.largest_batch);
+                total.accept_rate += statistics.accept_rate;
+                total.backlog_depth += statistics.backlog_depth;
+                total.backlog_limit += statistics.backlog_limit;
+            }
+            return total;
+        }
+
+        std::vector<AsyncAcceptor *> m_acceptors;
+
+        template <AsyncAcceptor::AcceptCallback accept_callback> void start_accept()
+        {
+            for (auto acceptor : m_acceptors)
+                acceptor->template async_accept_with_callback<accept_callback>();
+        }
 
         virtual Thread<SocketType> *create_threads() const = 0;
+        // Traces the statistics of server specific state on every balance pass
+        virtual void log_statistics() {}
 
     private:
+        using DeadlineTimer = boost::asio::basic_deadline_timer<boost::posix_time::ptime,
+                                                                boost::asio::time_traits<boost::posix_time::ptime>,
+                                                                boost::asio::io_context::executor_type>;
+
+        static constexpr auto balance_interval = 5;
+        static constexpr auto balance_threshold = 0.2;
+        static constexpr auto utilisation_tolerance = 0.05;
+
         Thread<SocketType> *m_threads{nullptr};
         int m_thread_count{0};
+        std::unique_ptr<DeadlineTimer> m_balance_timer;
+
+        static AsyncAcceptor *create_acceptor(boost::asio::io_context &io_context, const std::string &ip, int port,
+                                              const AcceptorOptions &options)
+        {
+            AsyncAcceptor *acceptor;
+            try
+            {
+                acceptor = new AsyncAcceptor(io_context, ip, port, options);
+            }
+            catch (const boost::system::system_error &e)
+            {
+                return nullptr;
+            }
+
+            if (!acceptor->bind())
+            {
+                delete acceptor;
+                return nullptr;
+            }
+            return acceptor;
+        }
 
         std::pair<boost::asio::ip::tcp::socket *, std::uint32_t> get_socket_for_accept()
         {
-            auto index = thread_with_min_connections();
+            auto index = thread_with_min_load();
             return std::make_pair(m_threads[index].get_socket_for_accept(), index);
         }
 
-        auto thread_with_min_connections() const
+        auto thread_with_min_load() const
         {
             std::uint32_t min = 0;
             for (int i = 1; i < m_thread_count; i++)
             {
-                if (m_threads[i].connection_count() < m_threads[min].connection_count())
+                auto difference = m_threads[i].utilisation() - m_threads[min].utilisation();
+                if (difference < -utilisation_tolerance)
+                    min = i;
+                else if (difference <= utilisation_tolerance &&
+                         m_threads[i].connection_count() < m_threads[min].connection_count())
                     min = i;
             }
             return min;
         }
+
+        void balance(boost::system::error_code error)
+        {
+            if (error)
+                return;
+
+            auto accept = accept_statistics();
+            LOG_TRACE("Accepted = {}, rate = {:.1f}/s, largest batch = {}, backlog = {}/{}", accept.accepted,
+                      accept.accept_rate, accept.largest_batch, accept.backlog_depth, accept.backlog_limit);
+            log_statistics();
+
+            int hot = 0;
+            int cold = 0;
+            for (int i = 0; i < m_thread_count; i++)
+            {
+                auto statistics = m_threads[i].statistics();
+                LOG_TRACE("Network thread = {}, utilisation = {:.3f}, connections = {}, write queue = {}", i,
+                          statistics.utilisation, statistics.connections, statistics.write_queue_depth);
+                LOG_TRACE("Network thread = {}, writes = {} packets in {} syscalls, {} bytes", i,
+                          statistics.write_packets, statistics.write_syscalls, statistics.write_bytes);
+                LOG_TRACE("Network thread = {}, buffer hit rate = {:.3f}, outstanding = {}, high water = {}, "
+                          "pooled = {}",
+                          i, statistics.buffer_hit_rate, statistics.buffers_outstanding, statistics.buffers_high_water,
+                          statistics.buffers_pooled);
+
+                if (m_threads[i].utilisation() > m_threads[hot].utilisation())
+                    hot = i;
+                if (m_threads[i].utilisation() < m_threads[cold].utilisation())
+                    cold = i;
+            }
+
+            auto hot_utilisation = m_threads[hot].utilisation();
+            auto difference = hot_utilisation - m_threads[cold].utilisation();
+            auto connections = m_threads[hot].connection_count();
+            if (difference > balance_threshold && connections > 1)
+            {
+                auto count = std::size_t(std::ceil(connections * difference / (2.0 * hot_utilisation)));
+                LOG_DEBUG("Migrating up to {} sessions from network thread {} to {}", count, hot, cold);
+                m_threads[hot].migrate_idle(count, m_threads[cold]);
+            }
+
+            m_balance_timer->expires_from_now(boost::posix_time::seconds(balance_interval));
+            m_balance_timer->async_wait([this](auto code) { balance(code); });
+        }
     };
 } // namespace Network
@@ -17,12 +17,34 @@
  */
 #pragma once
 
+#include <Utilities/BufferPool.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <chrono>
+#include <iostream>
 #include <thread>
 
 namespace Network
 {
+    struct ThreadStatistics
+    {
+        double utilisation{0.0};
+        int connections{0};
+        std::size_t write_queue_depth{0};
+        std::uint64_t migrated_in{0};
+        std::uint64_t migrated_out{0};
+        // Totals of every socket the thread has served
+        std::uint64_t write_syscalls{0};
+        std::uint64_t write_packets{0};
+        std::uint64_t write_bytes{0};
+        // Buffer pool of the thread as of its last update
+        double buffer_hit_rate{0.0};
+        std::int64_t buffers_outstanding{0};
+        std::int64_t buffers_high_water{0};
+        std::size_t buffers_pooled{0};
+    };
+
     template <class SocketType> class Thread
     {
     public:
@@ -39,6 +61,25 @@ namespace Network
         }
 
         int connection_count() { return m_connections; }
+        double utilisation() const { return m_utilisation; }
+
+        ThreadStatistics statistics() const
+        {
+            ThreadStatistics statistics;
+            statistics.utilisation = m_utilisation;
+            statistics.connections = m_connections;
+            statistics.write_queue_depth = m_write_queue_depth;
+            statistics.migrated_in = m_migrated_in;
+            statistics.migrated_out = m_migrated_out;
+            statistics.write_syscalls = m_write_syscalls;
+            statistics.write_packets = m_write_packets;
+            statistics.write_bytes = m_write_bytes;
+            statistics.buffer_hit_rate = m_buffer_hit_rate;
+            statistics.buffers_outstanding = m_buffers_outstanding;
+            statistics.buffers_high_water = m_buffers_high_water;
+            statistics.buffers_pooled = m_buffers_pooled;
+            return statistics;
+        }
 
         bool start()
         {
@@ -49,13 +90,60 @@ namespace Network
             return true;
         }
 
-        void append(std::shared_ptr<SocketType> socket)
+        void append(boost::asio::ip::tcp::socket &&socket)
+        {
+            m_connections++;
+            boost::asio::post(m_io_context, [this, socket = std::move(socket)]() mutable {
+                try
+                {
+                    auto new_socket = std::make_shared<SocketType>(std::move(socket));
+                    new_socket->start();
+                    m_sockets.push_back(new_socket);
+                }
+                catch (const boost::system::system_error &e)
+                {
+                    m_connections--;
+                    std::cerr << "Failed to start client socket - " << e.what() << std::endl;
+                }
+            });
+        }
+
+        // Both threads live in the thread array of one SocketManager for the life of the server, so the captured
+        // target and this outlive the posted work. Sockets are only touched on this thread until adopt posts them
+        // to the target
+        void migrate_idle(std::size_t count, Thread &target)
+        {
+            boost::asio::post(m_io_context, [this, count, &target]() {
+                std::size_t migrating = 0;
+                for (auto &socket : m_sockets)
+                {
+                    if (migrating == count)
+                        break;
+                    if (!socket->is_idle())
+                        continue;
+
+                    socket->migrate(target.io_context(), [this, &target](std::shared_ptr<SocketType> socket) {
+                        m_sockets.erase(std::remove(m_sockets.begin(), m_sockets.end(), socket), m_sockets.end());
+                        m_connections--;
+                        m_migrated_out++;
+                        target.adopt(std::move(socket));
+                    });
+                    migrating++;
+                }
+            });
+        }
+
+        void adopt(std::shared_ptr<SocketType> socket)
         {
-            std::lock_guard<std::mutex> lock(m_new_sockets_lock);
             m_connections++;
-            m_new_sockets.push_back(socket);
+            boost::asio::post(m_io_context, [this, socket = std::move(socket)]() {
+                m_migrated_in++;
+                m_sockets.push_back(socket);
+                socket->resume();
+            });
         }
 
+        auto &io_context() { return m_io_context; }
         auto get_socket_for_accept() { return &m_accept_socket; }
 
     private:
@@ -63,24 +151,38 @@ namespace Network
         typedef boost::asio::time_traits<boost::posix_time::ptime> TimeTraits;
         typedef boost::asio::io_context::executor_type Executor;
 
+        static constexpr auto update_interval = 1000;
+        static constexpr auto utilisation_smoothing = 0.5;
+
         std::atomic<bool> m_stopped{false};
         std::atomic<int> m_connections{0};
+        std::atomic<double> m_utilisation{0.0};
+        std::atomic<std::size_t> m_write_queue_depth{0};
+        std::atomic<std::uint64_t> m_migrated_in{0};
+        std::atomic<std::uint64_t> m_migrated_out{0};
+        std::atomic<std::uint64_t> m_write_syscalls{0};
+        std::atomic<std::uint64_t> m_write_packets{0};
+        std::atomic<std::uint64_t> m_write_bytes{0};
+        std::atomic<double> m_buffer_hit_rate{0.0};
+        std::atomic<std::int64_t> m_buffers_outstanding{0};
+        std::atomic<std::int64_t> m_buffers_high_water{0};
+        std::atomic<std::size_t> m_buffers_pooled{0};
+        std::chrono::steady_clock::time_point m_last_update;
         std::thread *m_thread{nullptr};
-        std::mutex m_new_sockets_lock;
         std::vector<std::shared_ptr<SocketType>> m_sockets;
-        std::vector<std::shared_ptr<SocketType>> m_new_sockets;
         boost::asio::io_context m_io_context;
         boost::asio::ip::tcp::socket m_accept_socket;
         boost::asio::basic_deadline_timer<Time, TimeTraits, Executor> m_update_timer;
 
         void run()
         {
-            m_update_timer.expires_from_now(boost::posix_time::milliseconds(1));
+            m_last_update = std::chrono::steady_clock::now();
+            m_update_timer.expires_from_now(boost::posix_time::milliseconds(update_interval));
             m_update_timer.async_wait([this](const boost::system::error_code &code) { update(); });
 
             m_io_context.run();
 
-            m_new_sockets.clear();
+            m_sockets.clear();
         }
 
         void update()
@@ -88,12 +190,21 @@ namespace Network
             if (m_stopped)
                 return;
 
-            m_update_timer.expires_from_now(boost::posix_time::milliseconds(1));
+            m_update_timer.expires_from_now(boost::posix_time::milliseconds(update_interval));
             m_update_timer.async_wait([this](const boost::system::error_code &code) { update(); });
 
-            add_new_sockets();
-
-            auto remove = [this](std::shared_ptr<SocketType> socket) -> bool {
+            auto now = std::chrono::steady_clock::now();
+            auto elapsed = now - std::exchange(m_last_update, now);
+            std::chrono::steady_clock::duration busy_time{};
+            std::size_t write_queue_depth = 0;
+
+            auto remove = [this, &busy_time, &write_queue_depth](std::shared_ptr<SocketType> socket) -> bool {
+                busy_time += socket->take_busy_time();
+                write_queue_depth += socket->write_queue_size();
+                auto writes = socket->take_write_statistics();
+                m_write_syscalls += writes.syscalls;
+                m_write_packets += writes.packets;
+                m_write_bytes += writes.bytes;
                 if (!socket->update())
                 {
                     if (socket->is_open())
@@ -106,22 +217,20 @@ namespace Network
             };
 
             m_sockets.erase(std::remove_if(m_sockets.begin(), m_sockets.end(), remove), m_sockets.end());
-        }
 
-        void add_new_sockets()
-        {
-            std::lock_guard<std::mutex> lock(m_new_sockets_lock);
-            if (m_new_sockets.empty())
-                return;
+            auto sample = elapsed.count() ? std::min(1.0, double(busy_time.count()) / double(elapsed.count())) : 0.0;
+            m_utilisation = utilisation_smoothing * m_utilisation + (1.0 - utilisation_smoothing) * sample;
+            m_write_queue_depth = write_queue_depth;
 
-            for (auto socket : m_new_sockets)
+            // Most pool counters are plain fields that only the owning thread may read, so they are copied out here
+            if (auto pool = Utilities::BufferPool::current())
             {
-                if (!socket->is_open())
-                    m_connections--;
-                else
-                    m_sockets.push_back(socket);
+                auto buffers = pool->statistics();
+                m_buffer_hit_rate = buffers.hit_rate();
+                m_buffers_outstanding = buffers.outstanding;
+                m_buffers_high_water = buffers.high_water;
+                m_buffers_pooled = pool->pooled_count();
             }
-            m_new_sockets.clear();
         }
 
         void stop()
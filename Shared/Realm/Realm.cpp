@@ -21,26 +21,40 @@
 
 namespace Realm
 {
-    boost::asio::ip::basic_endpoint<boost::asio::ip::tcp> Realm::address_for_client(
-        const boost::asio::ip::address &client_address) const
+    RealmAddress Realm::address_kind_for_client(const boost::asio::ip::address &client_address) const
     {
-        boost::asio::ip::address realm_ip;
         if (client_address.is_loopback())
         {
             if (local_address.is_loopback() || address.is_loopback())
-                realm_ip = client_address;
-            else
-                realm_ip = local_address;
+                return realmaddress_client;
+            return realmaddress_local;
         }
-        else
+
+        if (!client_address.is_v4())
+            return realmaddress_public;
+
+        auto network = boost::asio::ip::make_network_v4(local_address.to_v4(), local_subnet_mask.to_v4());
+        auto hosts = network.hosts();
+        if (hosts.find(client_address.to_v4()) != hosts.end())
+            return realmaddress_local;
+        return realmaddress_public;
+    }
+
+    boost::asio::ip::basic_endpoint<boost::asio::ip::tcp> Realm::address_for_client(
+        const boost::asio::ip::address &client_address) const
+    {
+        boost::asio::ip::address realm_ip;
+        switch (address_kind_for_client(client_address))
         {
-            auto network = boost::asio::ip::make_network_v4(local_address.to_v4(), local_subnet_mask.to_v4());
-            auto hosts = network.hosts();
-            auto client_in_network = hosts.find(client_address.to_v4()) != hosts.end();
-            if (client_address.is_v4() && client_in_network)
-                realm_ip = local_address;
-            else
-                realm_ip = address;
+        case realmaddress_client:
+            realm_ip = client_address;
+            break;
+        case realmaddress_local:
+            realm_ip = local_address;
+            break;
+        default:
+            realm_ip = address;
+            break;
         }
         return boost::asio::ip::basic_endpoint<boost::asio::ip::tcp>(realm_ip, port);
     }
@@ -47,6 +47,13 @@ namespace Realm
         realmflag_full = 0x80
     };
 
+    enum RealmAddress
+    {
+        realmaddress_public = 0,
+        realmaddress_local = 1,
+        realmaddress_client = 2
+    };
+
     struct Realm
     {
         std::uint32_t id;
@@ -61,6 +68,9 @@ namespace Realm
         float population;
         std::uint32_t build;
 
+        bool operator==(const Realm &right) const = default;
+
+        RealmAddress address_kind_for_client(const boost::asio::ip::address &client_address) const;
         boost::asio::ip::basic_endpoint<boost::asio::ip::tcp> address_for_client(
             const boost::asio::ip::address &client_address) const;
     };
@@ -16,8 +16,13 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include <Database/AuthDatabase.hpp>
+#include <Database/RowLoader.hpp>
 #include <Realm/RealmList.hpp>
+#include <Realm/RealmListSnapshot.hpp>
 #include <Utilities/Log.hpp>
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 namespace Realm
 {
@@ -38,32 +43,94 @@ namespace Realm
         init_builds();
         boost::system::error_code error;
         update_realms(error);
-    }
 
-    const RealmList::BuildInformation *RealmList::build_info(std::uint32_t build_number) const
-    {
-        for (const auto &build : m_builds)
+        // Lookups complete on the io_context, so drive it until the first list is out before sessions are accepted
+        if (io_context.stopped())
+            io_context.restart();
+        while (!snapshot() && io_context.run_one())
         {
-            if (build.build == build_number)
-                return &build;
         }
-        return nullptr;
+
+        m_status_socket = std::make_unique<boost::asio::ip::udp::socket>(io_context);
+        m_status_socket->open(boost::asio::ip::udp::v4(), error);
+        if (!error)
+            m_status_socket->bind({boost::asio::ip::address_v4::loopback(), realm_status_port}, error);
+        if (error)
+        {
+            LOG_ERROR("Failed to listen for realm status, port = {}, error = {}", realm_status_port, error.message());
+            return;
+        }
+        receive_status();
+    }
+
+    const RealmList::BuildInformation *RealmList::build_info(std::uint32_t build) const
+    {
+        auto slot = build_slot(build);
+        return slot.family != build_family_unknown ? &m_builds[slot.index] : nullptr;
+    }
+
+    RealmList::BuildFamily RealmList::build_family(std::uint32_t build) const
+    {
+        return build_slot(build).family;
+    }
+
+    RealmList::BuildSlot RealmList::build_slot(std::uint32_t build) const
+    {
+        // Builds below m_first_build wrap around past the end of the table
+        auto offset = build - m_first_build;
+        return offset < m_build_table.size() ? m_build_table[offset] : BuildSlot{0, build_family_unknown};
     }
 
     void RealmList::init_builds()
     {
-        if (auto query = Database::AuthDatabase::instance()->query(
-                "SELECT build, major, minor, revision FROM build_information"))
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<BuildInformation> builds;
+        Database::RowLoader loader(&BuildInformation::build, &BuildInformation::major, &BuildInformation::minor,
+                                   &BuildInformation::revision);
+        if (!loader.load(*Database::AuthDatabase::instance(),
+                         Database::PreparedStatement(Database::auth_select_builds), builds))
+            LOG_ERROR("Failed to load build information");
+        set_builds(std::move(builds));
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        LOG_INFO("Loaded {} build information entries in {} us", m_builds.size(), elapsed.count());
+    }
+
+    void RealmList::set_builds(std::vector<BuildInformation> builds)
+    {
+        m_builds = std::move(builds);
+        compile_builds();
+    }
+
+    void RealmList::compile_builds()
+    {
+        // Clients send their build in 16 bits, wider ones could never be looked up and would only grow the table
+        auto end = std::remove_if(m_builds.begin(), m_builds.end(), [](const BuildInformation &build) {
+            if (build.build <= std::numeric_limits<std::uint16_t>::max())
+                return false;
+            LOG_ERROR("Ignored build information of build = {}, builds are 16 bit", build.build);
+            return true;
+        });
+        m_builds.erase(end, m_builds.end());
+
+        m_build_table.clear();
+        if (m_builds.empty())
+            return;
+
+        auto [first, last] = std::minmax_element(m_builds.begin(), m_builds.end(),
+                                                 [](const auto &left, const auto &right) {
+                                                     return left.build < right.build;
+                                                 });
+        m_first_build = first->build;
+        m_build_table.assign(last->build - m_first_build + 1, BuildSlot{0, build_family_unknown});
+
+        // A build listed twice keeps its first row, as the linear lookup did
+        for (std::size_t i = m_builds.size(); i-- > 0;)
         {
-            do
-            {
-                auto fields = query->fetch();
-                auto &build = m_builds.emplace_back();
-                build.build = fields[0].get_uint32();
-                build.major = fields[1].get_uint32();
-                build.minor = fields[2].get_uint32();
-                build.revision = fields[3].get_uint32();
-            } while (query->next_row());
+            auto build = m_builds[i].build;
+            auto family = build <= max_pre_bc_client_build ? build_family_pre_bc : build_family_post_bc;
+            m_build_table[build - m_first_build] = BuildSlot{std::uint16_t(i), family};
         }
     }
 
@@ -72,95 +139,293 @@ namespace Realm
         if (error)
             return;
 
-        m_realms.clear();
+        auto update = std::make_shared<PendingUpdate>();
+        update->start = std::chrono::steady_clock::now();
+
+        // Rows only change without touching updated_at by being deleted, which shows as a known id no longer listed.
+        // Ids are compared rather than counted, a deleted row and an inserted one would leave the count as it was
+        auto previous = snapshot();
+        auto ids = previous ? listed_realm_ids() : std::nullopt;
+        if (previous && !ids)
+        {
+            LOG_ERROR("Failed to list realm ids, keeping snapshot = {}", m_snapshot_version);
+            schedule_update();
+            return;
+        }
+        update->full = !previous || update->start - m_last_full_update >= full_update_interval ||
+                       ids->size() != m_known_realms.size() ||
+                       !std::all_of(ids->begin(), ids->end(), [this](auto id) { return m_known_realms.count(id); });
+        Database::PreparedStatement statement(update->full ? Database::auth_select_realms
+                                                           : Database::auth_select_changed_realms);
+        if (!update->full)
+            statement.set_uint64(0, m_updated_at - std::min(m_updated_at, updated_at_window));
+
+        std::vector<RealmRow> rows;
+        Database::RowLoader loader(&RealmRow::id, &RealmRow::name, &RealmRow::address, &RealmRow::local_address,
+                                   &RealmRow::local_subnet_mask, &RealmRow::port, &RealmRow::type, &RealmRow::flags,
+                                   &RealmRow::category, &RealmRow::population, &RealmRow::build,
+                                   &RealmRow::updated_at);
+        // Full passes read the whole table, so they stream it in column batches rather than buffering every row
+        auto database = Database::AuthDatabase::instance();
+        auto loaded = update->full ? loader.load(*database, statement, rows, realm_batch_rows)
+                                   : loader.load(*database, statement, rows);
+        // A failed refresh keeps serving the previous list, only the first one publishes empty so init can go on
+        if (!loaded)
+        {
+            LOG_ERROR("Failed to load realm list, full = {}, snapshot = {}", update->full, m_snapshot_version);
+            rows.clear();
+            if (previous)
+            {
+                schedule_update();
+                return;
+            }
+        }
+        else if (update->full)
+            m_last_full_update = update->start;
+
+        for (auto &row : rows)
+        {
+            m_updated_at = std::max(m_updated_at, row.updated_at);
+            if (row.flags == unlisted_flags)
+                update->removed.push_back(row.id);
+            else
+                update->rows.push_back(std::move(row));
+        }
+
+        update->loaded = std::chrono::steady_clock::now();
+        update->addresses.resize(update->rows.size());
+        update->pending_lookups = update->rows.size() * 3;
+        if (!update->pending_lookups)
+        {
+            publish_realms(*update);
+            return;
+        }
 
-        if (auto query =
-                Database::AuthDatabase::instance()->query("SELECT id, name, address, local_address, local_subnet_mask, "
-                                                          "port, type, flags, category, population, build FROM "
-                                                          "realmlist WHERE flags <> 3"))
+        // Every lookup of every realm is issued up front, the last one to answer publishes the list
+        for (std::size_t i = 0; i < update->rows.size(); i++)
         {
-            do
+            const auto &row = update->rows[i];
+            const std::string *hosts[] = {&row.address, &row.local_address, &row.local_subnet_mask};
+            for (std::size_t kind = 0; kind < 3; kind++)
             {
-                auto fields = query->fetch();
-                auto id = fields[0].get_uint32();
-                auto name = fields[1].get_string();
-
-                auto address_string = fields[2].get_string();
-                auto address = m_resolver->resolve(boost::asio::ip::tcp::v4(), address_string, "");
-                if (!address)
-                {
-                    LOG_ERROR("Failed to resolve address = {}, realm = {}, id = {}", address_string.c_str(),
-                              name.c_str(), id);
-                    continue;
-                }
-
-                auto local_address_string = fields[3].get_string();
-                auto local_address = m_resolver->resolve(boost::asio::ip::tcp::v4(), local_address_string, "");
-                if (!local_address)
-                {
-                    LOG_ERROR("Failed to resolve local address = {}, realm = {}, id = {}", local_address_string.c_str(),
-                              name.c_str(), id);
-                    continue;
-                }
-
-                auto local_subnet_string = fields[4].get_string();
-                auto local_submask_address = m_resolver->resolve(boost::asio::ip::tcp::v4(), local_subnet_string, "");
-                if (!local_submask_address)
-                {
-                    LOG_ERROR("Failed to resolve local subnet mask = {}, realm = {}, id = {}",
-                              local_subnet_string.c_str(), name.c_str(), id);
-                    continue;
-                }
-
-                auto port = fields[5].get_uint16();
-                auto type = fields[6].get_uint8();
-                if (type == realmtype_ffa_pvp)
-                    type = realmtype_pvp;
-                if (type >= realmtype_max_client)
-                    type = realmtype_normal;
-                auto flags = fields[7].get_uint8();
-                auto category = fields[8].get_uint8();
-                auto population = fields[9].get_float();
-                auto build = fields[10].get_uint32();
-
-                if (!m_realms.contains(id))
-                {
-                    LOG_DEBUG("Added realm id = {}, name = {}, type = {}, flags = {}, population = {}, category = {}",
-                              id, name, type, flags, population, category);
-                }
-                else
-                {
-                    LOG_DEBUG("Updated realm id = {}, name = {}, type = {}, flags = {}, population = {}, category = {}",
-                              id, name, type, flags, population, category);
-                }
-
-                auto &realm = m_realms[id];
-                realm.id = id;
-                realm.name = name;
-                realm.address = address->address();
-                realm.local_address = local_address->address();
-                realm.local_subnet_mask = local_submask_address->address();
-                realm.port = port;
-                realm.type = type;
-                realm.flags = RealmFlags(flags);
-                realm.category = category;
-                realm.population = population;
-                realm.build = build;
-            } while (query->next_row());
+                m_resolver->async_resolve(boost::asio::ip::tcp::v4(), *hosts[kind], "",
+                                          [this, update, i, kind](std::optional<Network::Resolver::Endpoint> endpoint) {
+                                              auto elapsed = std::chrono::steady_clock::now() - update->loaded;
+                                              update->slowest_lookup = std::max(update->slowest_lookup, elapsed);
+                                              if (endpoint)
+                                                  update->addresses[i][kind] = endpoint->address();
+                                              if (!--update->pending_lookups)
+                                                  publish_realms(*update);
+                                          });
+            }
         }
+    }
+
+    void RealmList::publish_realms(const PendingUpdate &update)
+    {
+        auto resolved = std::chrono::steady_clock::now();
+
+        // The next table is built aside and published whole, sessions keep reading the previous one meanwhile
+        auto previous = snapshot();
+        std::map<std::uint32_t, Realm> realms;
+        if (update.full)
+            m_known_realms.clear();
+        else
+            realms = previous->realms();
 
+        std::size_t changed = 0;
+        for (auto id : update.removed)
+        {
+            m_known_realms.erase(id);
+            if (realms.erase(id))
+            {
+                LOG_DEBUG("Removed realm id = {}", id);
+                changed++;
+            }
+        }
+
+        for (std::size_t i = 0; i < update.rows.size(); i++)
+        {
+            const auto &row = update.rows[i];
+            auto id = row.id;
+            const auto &name = row.name;
+
+            const auto &address = update.addresses[i][0];
+            if (!address)
+            {
+                LOG_ERROR("Failed to resolve address = {}, realm = {}, id = {}", row.address.c_str(), name.c_str(),
+                          id);
+                realms.erase(id);
+                continue;
+            }
+
+            const auto &local_address = update.addresses[i][1];
+            if (!local_address)
+            {
+                LOG_ERROR("Failed to resolve local address = {}, realm = {}, id = {}", row.local_address.c_str(),
+                          name.c_str(), id);
+                realms.erase(id);
+                continue;
+            }
+
+            const auto &local_submask_address = update.addresses[i][2];
+            if (!local_submask_address)
+            {
+                LOG_ERROR("Failed to resolve local subnet mask = {}, realm = {}, id = {}",
+                          row.local_subnet_mask.c_str(), name.c_str(), id);
+                realms.erase(id);
+                continue;
+            }
+
+            // Only realms listed with their addresses count as known, the others are looked up again next pass
+            m_known_realms.insert(id);
+
+            auto type = row.type;
+            if (type == realmtype_ffa_pvp)
+                type = realmtype_pvp;
+            if (type >= realmtype_max_client)
+                type = realmtype_normal;
+
+            Realm realm;
+            realm.id = id;
+            realm.name = name;
+            realm.address = *address;
+            realm.local_address = *local_address;
+            realm.local_subnet_mask = *local_submask_address;
+            realm.port = row.port;
+            realm.type = type;
+            realm.flags = RealmFlags(row.flags);
+            realm.category = row.category;
+            realm.population = row.population;
+            realm.build = row.build;
+
+            // Rows fetched again without a change in content are not worth a log line or a new snapshot
+            auto existing = previous ? previous->realms().find(id) : realms.end();
+            if (!previous || existing == previous->realms().end())
+            {
+                LOG_DEBUG("Added realm id = {}, name = {}, type = {}, flags = {}, population = {}, category = {}",
+                          id, name, type, row.flags, row.population, row.category);
+                changed++;
+            }
+            else if (!(existing->second == realm))
+            {
+                LOG_DEBUG("Updated realm id = {}, name = {}, type = {}, flags = {}, population = {}, category = {}",
+                          id, name, type, row.flags, row.population, row.category);
+                changed++;
+            }
+            realms[id] = std::move(realm);
+        }
+
+        auto serialize_start = std::chrono::steady_clock::now();
+        auto realm_count = realms.size();
+        if (!previous || realms != previous->realms())
+            publish(std::move(realms));
+
+        auto now = std::chrono::steady_clock::now();
+        auto query_time = std::chrono::duration_cast<std::chrono::microseconds>(update.loaded - update.start);
+        auto resolve_time = std::chrono::duration_cast<std::chrono::microseconds>(resolved - update.loaded);
+        auto slowest_time = std::chrono::duration_cast<std::chrono::microseconds>(update.slowest_lookup);
+        auto snapshot_time = std::chrono::duration_cast<std::chrono::microseconds>(now - serialize_start);
+        auto total_time = std::chrono::duration_cast<std::chrono::microseconds>(now - update.start);
+        LOG_DEBUG("Updated {} realms, full = {}, rows = {}, changed = {}, snapshot = {}, query = {} us, "
+                  "resolve = {} us (slowest lookup {} us), serialize = {} us, total = {} us",
+                  realm_count, update.full, update.rows.size() + update.removed.size(), changed, m_snapshot_version,
+                  query_time.count(), resolve_time.count(), slowest_time.count(), snapshot_time.count(),
+                  total_time.count());
+
+        schedule_update();
+    }
+
+    void RealmList::schedule_update()
+    {
         m_timer->expires_from_now(boost::posix_time::seconds(30));
         m_timer->async_wait([this](auto code) { update_realms(code); });
     }
 
-    bool RealmList::is_pre_bc_client(std::uint32_t build)
+    void RealmList::publish(std::map<std::uint32_t, Realm> realms)
+    {
+        auto snapshot = std::make_shared<const RealmListSnapshot>(++m_snapshot_version, std::move(realms), *this);
+        std::atomic_store_explicit(&m_snapshot, std::move(snapshot), std::memory_order_release);
+    }
+
+    std::optional<std::vector<std::uint32_t>> RealmList::listed_realm_ids() const
+    {
+        struct RealmId
+        {
+            std::uint32_t id;
+        };
+
+        std::vector<RealmId> rows;
+        Database::RowLoader loader(&RealmId::id);
+        if (!loader.load(*Database::AuthDatabase::instance(),
+                         Database::PreparedStatement(Database::auth_select_realm_ids), rows))
+            return std::nullopt;
+
+        std::vector<std::uint32_t> ids;
+        ids.reserve(rows.size());
+        for (const auto &row : rows)
+            ids.push_back(row.id);
+        return ids;
+    }
+
+    void RealmList::receive_status()
+    {
+        m_status_socket->async_receive(boost::asio::buffer(&m_status, sizeof(m_status)),
+                                       [this](const boost::system::error_code &error, std::size_t size) {
+                                           if (error)
+                                           {
+                                               if (error != boost::asio::error::operation_aborted)
+                                                   LOG_ERROR("Realm status receive failed, error = {}",
+                                                             error.message());
+                                               return;
+                                           }
+
+                                           if (size == sizeof(m_status))
+                                               apply_status(m_status);
+                                           receive_status();
+                                       });
+    }
+
+    void RealmList::apply_status(const realm_status_t &status)
+    {
+        auto previous = snapshot();
+        if (!previous)
+            return;
+
+        auto found = previous->realms().find(status.id);
+        if (found == previous->realms().end())
+        {
+            LOG_DEBUG("Ignored status of unlisted realm id = {}", status.id);
+            return;
+        }
+
+        auto realm = found->second;
+        realm.flags = RealmFlags(std::uint8_t((realm.flags | status.set_flags) & ~status.clear_flags));
+        if (status.has_population)
+            realm.population = status.population;
+        if (realm == found->second)
+            return;
+
+        // The database row follows through the world server writes, the next refresh only confirms this change
+        auto realms = previous->realms();
+        if (realm.flags == unlisted_flags)
+            realms.erase(realm.id);
+        else
+            realms[realm.id] = realm;
+        publish(std::move(realms));
+
+        LOG_DEBUG("Applied status of realm id = {}, flags = {}, population = {}, snapshot = {}", realm.id,
+                  std::uint32_t(realm.flags), realm.population, m_snapshot_version);
+    }
+
+    bool RealmList::is_pre_bc_client(std::uint32_t build) const
     {
-        return build <= max_pre_bc_client_build && build_info(build);
+        return build_family(build) == build_family_pre_bc;
     }
 
-    bool RealmList::is_post_bc_client(std::uint32_t build)
+    bool RealmList::is_post_bc_client(std::uint32_t build) const
     {
-        return build > max_pre_bc_client_build && build_info(build);
+        return build_family(build) == build_family_post_bc;
     }
 
 } // namespace Realm
@@ -19,12 +19,21 @@
 
 #include <Network/Resolver.hpp>
 #include <Realm/Realm.hpp>
+#include <Realm/RealmStatus.hpp>
+#include <atomic>
+#include <array>
 #include <boost/asio/deadline_timer.hpp>
+#include <chrono>
 #include <map>
+#include <optional>
+#include <unordered_set>
+#include <memory>
 #include <vector>
 
 namespace Realm
 {
+    class RealmListSnapshot;
+
     class RealmList
     {
     public:
@@ -37,30 +46,112 @@ namespace Realm
             std::uint32_t revision;
         };
 
+        enum BuildFamily : std::uint8_t
+        {
+            build_family_unknown = 0,
+            build_family_pre_bc = 1,
+            build_family_post_bc = 2
+        };
+
         static RealmList *instance();
 
-        const auto &realms() const { return m_realms; }
+        // Latest published realm list, null until init has run. Readers on any thread keep the snapshot they loaded
+        // alive on their own while the updater swaps in the next one
+        std::shared_ptr<const RealmListSnapshot> snapshot() const
+        {
+            return std::atomic_load_explicit(&m_snapshot, std::memory_order_acquire);
+        }
 
         void init(boost::asio::io_context &io_context);
+        // Replaces the build information and compiles its lookup table, before any session looks builds up
+        void set_builds(std::vector<BuildInformation> builds);
         const BuildInformation *build_info(std::uint32_t build) const;
+        BuildFamily build_family(std::uint32_t build) const;
 
-        bool is_pre_bc_client(std::uint32_t build);
-        bool is_post_bc_client(std::uint32_t build);
+        bool is_pre_bc_client(std::uint32_t build) const;
+        bool is_post_bc_client(std::uint32_t build) const;
 
     private:
         using DeadlineTimer = boost::asio::basic_deadline_timer<boost::posix_time::ptime,
                                                                 boost::asio::time_traits<boost::posix_time::ptime>,
                                                                 boost::asio::io_context::executor_type>;
 
+        struct RealmRow
+        {
+            std::uint32_t id;
+            std::string name;
+            std::string address;
+            std::string local_address;
+            std::string local_subnet_mask;
+            std::uint16_t port;
+            std::uint8_t type;
+            std::uint8_t flags;
+            std::uint8_t category;
+            float population;
+            std::uint32_t build;
+            std::uint64_t updated_at;
+        };
+
+        // One refresh in flight: the loaded rows and their addresses (public, local, subnet mask) as lookups finish
+        struct PendingUpdate
+        {
+            // Full updates rebuild the list from rows, the others apply rows and removed onto the current snapshot
+            bool full;
+            std::vector<RealmRow> rows;
+            std::vector<std::uint32_t> removed;
+            std::vector<std::array<std::optional<boost::asio::ip::address>, 3>> addresses;
+            std::size_t pending_lookups;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point loaded;
+            std::chrono::steady_clock::duration slowest_lookup{};
+        };
+
         static constexpr auto max_pre_bc_client_build = 6141;
+        static constexpr std::size_t realm_batch_rows = 256;
+        // updated_at is stamped when a statement runs rather than when it commits, so a row committed late can land
+        // below the watermark. Delta passes read back this many seconds behind it
+        static constexpr std::uint64_t updated_at_window = 60;
+        // Full passes look every address up again, so answers whose cache entry expired are renewed
+        static constexpr auto full_update_interval = std::chrono::minutes(5);
+        // Rows flagged this way are left out of the realm list
+        static constexpr auto unlisted_flags = std::uint8_t(realmflag_version_mismatch | realmflag_offline);
         static RealmList *m_instance;
 
+        // Builds are looked up on every logon, so once loaded they are compiled into a table indexed directly by
+        // build - m_first_build whose slots carry the family next to the position in m_builds
+        struct BuildSlot
+        {
+            std::uint16_t index;
+            BuildFamily family;
+        };
+
         std::vector<BuildInformation> m_builds;
-        std::map<std::uint32_t, Realm> m_realms;
+        std::uint32_t m_first_build{0};
+        std::vector<BuildSlot> m_build_table;
+        // Only read and written through the atomic shared_ptr functions, std::atomic<std::shared_ptr> needs GCC 12
+        std::shared_ptr<const RealmListSnapshot> m_snapshot;
+        std::uint64_t m_snapshot_version{0};
+        // Newest updated_at seen, rows changed at or after it are fetched on the next pass
+        std::uint64_t m_updated_at{0};
+        std::chrono::steady_clock::time_point m_last_full_update;
+        // Every listable row of the table whose addresses resolved, compared with the listed ids so that deleted rows
+        // and rows still waiting for their addresses bring a full pass
+        std::unordered_set<std::uint32_t> m_known_realms;
+        std::unique_ptr<boost::asio::ip::udp::socket> m_status_socket;
+        realm_status_t m_status{};
         std::unique_ptr<Network::Resolver> m_resolver;
         std::unique_ptr<DeadlineTimer> m_timer;
 
         void init_builds();
+        void compile_builds();
+        BuildSlot build_slot(std::uint32_t build) const;
         void update_realms(boost::system::error_code error);
+        void publish_realms(const PendingUpdate &update);
+        void publish(std::map<std::uint32_t, Realm> realms);
+        void schedule_update();
+        std::optional<std::vector<std::uint32_t>> listed_realm_ids() const;
+
+        void receive_status();
+        void apply_status(const realm_status_t &status);
     };
 } // namespace Realm
@@ -0,0 +1,152 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Realm/RealmListSnapshot.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fmt/format.h>
+
+namespace Realm
+{
+    RealmListSnapshot::RealmListSnapshot(std::uint64_t version, std::map<std::uint32_t, Realm> realms,
+                                         const RealmList &realm_list)
+        : m_version(version), m_realms(std::move(realms))
+    {
+        m_entries.reserve(m_realms.size());
+        for (const auto &[id, realm] : m_realms)
+        {
+            auto &entry = m_entries.emplace_back();
+            entry.realm = &realm;
+            if (auto build_info = realm_list.build_info(realm.build))
+                entry.build_info = *build_info;
+
+            const boost::asio::ip::address addresses[] = {realm.address, realm.local_address};
+            for (std::size_t family = 0; family < max_client_families; family++)
+            {
+                for (std::size_t matches = 0; matches < 2; matches++)
+                {
+                    for (std::size_t kind = 0; kind < realmaddress_client; kind++)
+                        entry.fragments[family][matches][kind] = serialize(
+                            realm, entry.build_info, ClientFamily(family), matches, addresses[kind]);
+                }
+            }
+        }
+    }
+
+    void RealmListSnapshot::write(Utilities::ByteBuffer &buffer, ClientFamily family, std::uint32_t build,
+                                  const boost::asio::ip::address &client_address,
+                                  const std::map<std::uint32_t, std::uint8_t> &characters) const
+    {
+        auto count_position = buffer.wpos();
+        if (family == client_family_post_bc)
+            buffer << std::uint16_t(0);
+        else
+            buffer << std::uint8_t(0);
+
+        std::size_t count = 0;
+        for (const auto &entry : m_entries)
+        {
+            const auto &realm = *entry.realm;
+            auto matches = realm.build == build;
+            auto kind = realm.address_kind_for_client(client_address);
+
+            // Loopback setups send the client its own address back, which can not be prepared ahead
+            Fragment client_fragment;
+            const Fragment *fragment;
+            if (kind == realmaddress_client)
+            {
+                client_fragment = serialize(realm, entry.build_info, family, matches, client_address);
+                fragment = &client_fragment;
+            }
+            else
+                fragment = &entry.fragments[family][matches][kind];
+
+            if (fragment->bytes.empty())
+                continue;
+
+            auto start = buffer.wpos();
+            buffer.append(fragment->bytes.data(), fragment->bytes.size());
+            auto found = characters.find(realm.id);
+            buffer.put(start + fragment->characters_position,
+                       std::uint8_t(found != characters.end() ? found->second : 0));
+            count++;
+        }
+
+        if (family == client_family_post_bc)
+        {
+            buffer << std::uint8_t(0x10);
+            buffer << std::uint8_t(0x00);
+            buffer.put(count_position, std::uint16_t(count));
+        }
+        else
+        {
+            buffer << std::uint8_t(0x00);
+            buffer << std::uint8_t(0x02);
+            buffer.put(count_position, std::uint8_t(count));
+        }
+    }
+
+    RealmListSnapshot::Fragment RealmListSnapshot::serialize(
+        const Realm &realm, const std::optional<RealmList::BuildInformation> &build_info, ClientFamily family,
+        bool build_matches, const boost::asio::ip::address &address)
+    {
+        Fragment fragment;
+        std::uint32_t flags = realm.flags;
+        if (!build_matches)
+        {
+            if (!build_info)
+                return fragment;
+            flags |= realmflag_offline | realmflag_specifybuild;
+        }
+        if (!build_info)
+            flags &= ~realmflag_specifybuild;
+
+        auto name = realm.name;
+        if (family == client_family_pre_bc && flags & realmflag_specifybuild)
+            name = fmt::format("{} ({}.{}.{})", name, build_info->major, build_info->minor, build_info->revision);
+
+        Utilities::ByteBuffer buffer;
+        if (family == client_family_post_bc)
+        {
+            buffer << std::uint8_t(realm.type);
+            buffer << std::uint8_t(0x01);
+        }
+        else
+            buffer << std::uint32_t(realm.type);
+        buffer << std::uint8_t(flags);
+        buffer << name;
+        buffer << boost::lexical_cast<std::string>(boost::asio::ip::tcp::endpoint(address, realm.port));
+        buffer << float(realm.population);
+        fragment.characters_position = buffer.wpos();
+        buffer << std::uint8_t(0);
+        buffer << std::uint8_t(realm.category);
+        if (family == client_family_post_bc)
+            buffer << std::uint8_t(realm.id);
+        else
+            buffer << std::uint8_t(0x00);
+
+        if (family == client_family_post_bc && flags & realmflag_specifybuild)
+        {
+            buffer << std::uint8_t(build_info->major);
+            buffer << std::uint8_t(build_info->minor);
+            buffer << std::uint8_t(build_info->revision);
+            buffer << std::uint16_t(build_info->build);
+        }
+
+        fragment.bytes.assign(buffer.data(), buffer.data() + buffer.size());
+        return fragment;
+    }
+} // namespace Realm
@@ -0,0 +1,80 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <Realm/Realm.hpp>
+#include <Realm/RealmList.hpp>
+#include <Utilities/ByteBuffer.hpp>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace Realm
+{
+    // Immutable view of the realm list published after every update, holding each realm entry of the realmlist reply
+    // already serialised per client family, build match and address so a reply only splices bytes together
+    class RealmListSnapshot
+    {
+    public:
+        enum ClientFamily
+        {
+            client_family_pre_bc = 0,
+            client_family_post_bc = 1,
+            max_client_families = 2
+        };
+
+        RealmListSnapshot(std::uint64_t version, std::map<std::uint32_t, Realm> realms, const RealmList &realm_list);
+        // Entries point into m_realms, so a snapshot stays where it was built
+        RealmListSnapshot(const RealmListSnapshot &) = delete;
+        RealmListSnapshot(RealmListSnapshot &&) = delete;
+        RealmListSnapshot &operator=(const RealmListSnapshot &) = delete;
+        RealmListSnapshot &operator=(RealmListSnapshot &&) = delete;
+
+        auto version() const { return m_version; }
+        const auto &realms() const { return m_realms; }
+
+        // Appends the realm count, the entries and the footer of a realmlist reply, characters maps realm ids to the
+        // character count of the account
+        void write(Utilities::ByteBuffer &buffer, ClientFamily family, std::uint32_t build,
+                   const boost::asio::ip::address &client_address,
+                   const std::map<std::uint32_t, std::uint8_t> &characters) const;
+
+    private:
+        struct Fragment
+        {
+            // Left empty when the realm is not listed for this client
+            std::vector<std::uint8_t> bytes;
+            std::size_t characters_position{0};
+        };
+
+        struct Entry
+        {
+            const Realm *realm;
+            std::optional<RealmList::BuildInformation> build_info;
+            // Indexed by client family, whether the client runs the realm build and the realm address kind
+            Fragment fragments[max_client_families][2][realmaddress_client];
+        };
+
+        std::uint64_t m_version;
+        std::map<std::uint32_t, Realm> m_realms;
+        std::vector<Entry> m_entries;
+
+        static Fragment serialize(const Realm &realm, const std::optional<RealmList::BuildInformation> &build_info,
+                                  ClientFamily family, bool build_matches, const boost::asio::ip::address &address);
+    };
+} // namespace Realm
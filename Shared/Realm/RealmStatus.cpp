@@ -0,0 +1,37 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Realm/RealmStatus.hpp>
+#include <Utilities/Log.hpp>
+#include <boost/asio/buffer.hpp>
+
+namespace Realm
+{
+    RealmStatusSender::RealmStatusSender(boost::asio::io_context &io_context)
+        : m_socket(io_context, boost::asio::ip::udp::v4()),
+          m_endpoint(boost::asio::ip::address_v4::loopback(), realm_status_port)
+    {
+    }
+
+    void RealmStatusSender::send(const realm_status_t &status)
+    {
+        boost::system::error_code error;
+        m_socket.send_to(boost::asio::buffer(&status, sizeof(status)), m_endpoint, 0, error);
+        if (error)
+            LOG_DEBUG("Failed to send realm status, id = {}, error = {}", status.id, error.message());
+    }
+} // namespace Realm
@@ -0,0 +1,54 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <cstdint>
+
+namespace Realm
+{
+    // Loopback datagram a world server sends the authentication server whenever its realm status changes, so the
+    // realm list reflects it without waiting for the next database refresh
+#pragma pack(push, 1)
+    typedef struct
+    {
+        std::uint32_t id;
+        std::uint8_t set_flags;
+        std::uint8_t clear_flags;
+        std::uint8_t has_population;
+        float population;
+    } realm_status_t;
+    static_assert(sizeof(realm_status_t) == (4 + 1 + 1 + 1 + 4));
+#pragma pack(pop)
+
+    constexpr std::uint16_t realm_status_port = 3725;
+
+    class RealmStatusSender
+    {
+    public:
+        explicit RealmStatusSender(boost::asio::io_context &io_context);
+
+        // Best effort, a status lost while the authentication server is down is picked up from the database
+        void send(const realm_status_t &status);
+
+    private:
+        boost::asio::ip::udp::socket m_socket;
+        boost::asio::ip::udp::endpoint m_endpoint;
+    };
+} // namespace Realm
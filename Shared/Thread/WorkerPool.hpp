@@ -0,0 +1,109 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Thread
+{
+    class WorkerPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        explicit WorkerPool(std::size_t thread_count, std::size_t capacity = 0) : m_capacity(capacity)
+        {
+            for (std::size_t i = 0; i < thread_count; i++)
+                m_threads.emplace_back(&WorkerPool::run, this);
+        }
+
+        ~WorkerPool() { stop(); }
+
+        bool enqueue(Task task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_stopped || (m_capacity && m_tasks.size() >= m_capacity))
+                    return false;
+                m_tasks.push_back(std::move(task));
+            }
+            m_condition.notify_one();
+            return true;
+        }
+
+        std::size_t queue_size() const
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_tasks.size();
+        }
+
+        auto thread_count() const { return m_threads.size(); }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_stopped)
+                    return;
+                m_stopped = true;
+            }
+            m_condition.notify_all();
+
+            for (auto &thread : m_threads)
+            {
+                if (thread.joinable())
+                    thread.join();
+            }
+        }
+
+    private:
+        std::size_t m_capacity{0};
+        bool m_stopped{false};
+        mutable std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::deque<Task> m_tasks;
+        std::vector<std::thread> m_threads;
+
+        void run()
+        {
+            while (true)
+            {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(m_lock);
+                    m_condition.wait(lock, [this]() { return m_stopped || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                        return;
+
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+    };
+} // namespace Thread
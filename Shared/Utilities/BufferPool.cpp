@@ -0,0 +1,160 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Utilities/BufferPool.hpp>
+
+namespace Utilities
+{
+    namespace
+    {
+        thread_local BufferPool *current_pool = nullptr;
+        thread_local bool thread_exiting = false;
+    } // namespace
+
+    // Pools are never deleted, buffers that outlive their thread still hold a valid owner. The free lists are given
+    // back when the thread exits, leaving only the pool object itself behind
+    struct BufferPool::ThreadExit
+    {
+        ~ThreadExit()
+        {
+            thread_exiting = true;
+            if (current_pool)
+            {
+                for (auto &free : current_pool->m_free)
+                    std::vector<std::vector<std::uint8_t>>().swap(free);
+            }
+            current_pool = nullptr;
+        }
+    };
+
+    BufferPool::BufferPool()
+    {
+        for (auto &free : m_free)
+            free.reserve(max_pooled_per_class);
+    }
+
+    BufferPool *BufferPool::current()
+    {
+        if (!current_pool && !thread_exiting)
+        {
+            static thread_local ThreadExit thread_exit;
+            current_pool = new BufferPool();
+        }
+        return current_pool;
+    }
+
+    std::vector<std::uint8_t> BufferPool::acquire(std::size_t size, BufferPool *&owner)
+    {
+        owner = current();
+        if (owner)
+            return owner->take(size);
+
+        std::vector<std::uint8_t> buffer;
+        buffer.reserve(size);
+        return buffer;
+    }
+
+    void BufferPool::release(BufferPool *owner, std::vector<std::uint8_t> &&buffer)
+    {
+        if (!owner)
+        {
+            std::vector<std::uint8_t>().swap(buffer);
+            return;
+        }
+
+        if (owner == current_pool)
+        {
+            owner->recycle(std::move(buffer));
+            return;
+        }
+
+        owner->m_outstanding.fetch_sub(1, std::memory_order_relaxed);
+        owner->m_remote_releases.fetch_add(1, std::memory_order_relaxed);
+        std::vector<std::uint8_t>().swap(buffer);
+    }
+
+    std::vector<std::uint8_t> BufferPool::take(std::size_t size)
+    {
+        auto outstanding = m_outstanding.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (outstanding > m_statistics.high_water)
+            m_statistics.high_water = outstanding;
+
+        for (std::size_t i = 0; i < size_classes.size(); i++)
+        {
+            if (size > size_classes[i])
+                continue;
+
+            auto &free = m_free[i];
+            if (!free.empty())
+            {
+                m_statistics.hits++;
+                auto buffer = std::move(free.back());
+                free.pop_back();
+                return buffer;
+            }
+
+            m_statistics.misses++;
+            std::vector<std::uint8_t> buffer;
+            buffer.reserve(size_classes[i]);
+            return buffer;
+        }
+
+        m_statistics.misses++;
+        std::vector<std::uint8_t> buffer;
+        buffer.reserve(size);
+        return buffer;
+    }
+
+    void BufferPool::recycle(std::vector<std::uint8_t> &&buffer)
+    {
+        m_outstanding.fetch_sub(1, std::memory_order_relaxed);
+
+        auto capacity = buffer.capacity();
+        for (auto i = size_classes.size(); i-- > 0;)
+        {
+            if (capacity < size_classes[i])
+                continue;
+
+            auto &free = m_free[i];
+            if (free.size() == max_pooled_per_class)
+                break;
+
+            buffer.clear();
+            free.push_back(std::move(buffer));
+            return;
+        }
+
+        m_statistics.discarded++;
+        std::vector<std::uint8_t>().swap(buffer);
+    }
+
+    BufferPool::Statistics BufferPool::statistics() const
+    {
+        auto statistics = m_statistics;
+        statistics.outstanding = m_outstanding.load(std::memory_order_relaxed);
+        statistics.remote_releases = m_remote_releases.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+    std::size_t BufferPool::pooled_count() const
+    {
+        std::size_t count = 0;
+        for (const auto &free : m_free)
+            count += free.size();
+        return count;
+    }
+} // namespace Utilities
@@ -0,0 +1,73 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Utilities
+{
+    // Per-thread free lists of buffer storage. Storage remembers the pool it came from: released on that pool's thread
+    // it goes back to the free lists, released on any other thread, or after the owning thread has exited, it only
+    // leaves the owner's outstanding count and goes back to the allocator
+    class BufferPool
+    {
+    public:
+        struct Statistics
+        {
+            std::uint64_t hits{0};
+            std::uint64_t misses{0};
+            std::uint64_t discarded{0};
+            std::uint64_t remote_releases{0};
+            std::int64_t outstanding{0};
+            std::int64_t high_water{0};
+
+            double hit_rate() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+        };
+
+        // The calling thread's pool, null once the thread has started tearing down its thread locals
+        static BufferPool *current();
+
+        // Storage of at least size bytes from the calling thread's pool, owner receives the pool to release it to
+        static std::vector<std::uint8_t> acquire(std::size_t size, BufferPool *&owner);
+        // Storage without an owner is not counted by any pool and is simply freed
+        static void release(BufferPool *owner, std::vector<std::uint8_t> &&buffer);
+
+        // Only safe on the owning thread, hits, misses, discards and the free lists are not synchronised
+        Statistics statistics() const;
+        std::size_t pooled_count() const;
+
+    private:
+        struct ThreadExit;
+
+        static constexpr std::array<std::size_t, 6> size_classes = {64, 256, 1024, 4096, 16384, 65536};
+        static constexpr std::size_t max_pooled_per_class = 256;
+
+        std::array<std::vector<std::vector<std::uint8_t>>, size_classes.size()> m_free;
+        Statistics m_statistics;
+        std::atomic<std::int64_t> m_outstanding{0};
+        std::atomic<std::uint64_t> m_remote_releases{0};
+
+        BufferPool();
+
+        std::vector<std::uint8_t> take(std::size_t size);
+        void recycle(std::vector<std::uint8_t> &&buffer);
+    };
+} // namespace Utilities
@@ -15,20 +15,45 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <Utilities/BufferPool.hpp>
 #include <Utilities/ByteBuffer.hpp>
 #include <cassert>
 #include <cstring>
+#include <utility>
 
 namespace Utilities
 {
-    ByteBuffer::ByteBuffer() { m_data.reserve(initial_size); }
+    ByteBuffer::ByteBuffer() : ByteBuffer(std::size_t(initial_size)) {}
 
-    ByteBuffer::ByteBuffer(std::size_t size) { m_data.reserve(size); }
+    ByteBuffer::ByteBuffer(std::size_t size) : m_data(BufferPool::acquire(size, m_pool)) {}
 
-    ByteBuffer::ByteBuffer(MessageBuffer &&buffer) : m_data(buffer.move()) {}
+    ByteBuffer::ByteBuffer(MessageBuffer &&buffer) : m_pool(buffer.pool()), m_data(buffer.move()) {}
+
+    ByteBuffer::ByteBuffer(ByteBuffer &&right) noexcept
+        : m_pool(std::exchange(right.m_pool, nullptr)), m_data(std::move(right.m_data)),
+          m_write_pos(std::exchange(right.m_write_pos, 0)), m_read_pos(std::exchange(right.m_read_pos, 0))
+    {
+    }
+
+    ByteBuffer::~ByteBuffer() { BufferPool::release(m_pool, std::move(m_data)); }
+
+    ByteBuffer &ByteBuffer::operator=(ByteBuffer &&right) noexcept
+    {
+        if (this == &right)
+            return *this;
+
+        BufferPool::release(m_pool, std::move(m_data));
+        m_pool = std::exchange(right.m_pool, nullptr);
+        m_data = std::move(right.m_data);
+        m_write_pos = std::exchange(right.m_write_pos, 0);
+        m_read_pos = std::exchange(right.m_read_pos, 0);
+        return *this;
+    }
 
     std::size_t ByteBuffer::size() const { return m_data.size(); }
 
+    std::size_t ByteBuffer::wpos() const { return m_write_pos; }
+
     std::uint8_t *ByteBuffer::data() { return m_data.data(); }
     const std::uint8_t *ByteBuffer::data() const { return m_data.data(); }
 
@@ -84,13 +109,13 @@ namespace Utilities
         if (m_data.capacity() < new_size)
         {
             if (new_size < 100)
-                m_data.reserve(300);
+                reserve(300);
             else if (new_size < 750)
-                m_data.reserve(2500);
+                reserve(2500);
             else if (new_size < 6000)
-                m_data.reserve(10000);
+                reserve(10000);
             else
-                m_data.reserve(400000);
+                reserve(400000);
         }
 
         if (m_data.size() < new_size)
@@ -100,6 +125,17 @@ namespace Utilities
         m_write_pos = new_size;
     }
 
+    template <typename T> void ByteBuffer::put(std::size_t position, T value)
+    {
+        static_assert(std::is_fundamental<T>::value);
+        assert(position + sizeof(value) <= size());
+        std::memcpy(&m_data[position], &value, sizeof(value));
+    }
+
+    template void ByteBuffer::put<std::uint8_t>(std::size_t position, std::uint8_t value);
+    template void ByteBuffer::put<std::uint16_t>(std::size_t position, std::uint16_t value);
+    template void ByteBuffer::put<std::uint32_t>(std::size_t position, std::uint32_t value);
+
     void ByteBuffer::append(const ByteBuffer &buffer)
     {
         if (!buffer.m_write_pos)
@@ -110,8 +146,30 @@ namespace Utilities
 
     void ByteBuffer::resize(std::size_t new_size)
     {
+        reserve(new_size);
         m_data.resize(new_size, 0);
         m_read_pos = 0;
         m_write_pos = size();
     }
+
+    std::vector<std::uint8_t> &&ByteBuffer::move()
+    {
+        m_pool = nullptr;
+        m_write_pos = 0;
+        m_read_pos = 0;
+        return std::move(m_data);
+    }
+
+    void ByteBuffer::reserve(std::size_t size)
+    {
+        if (m_data.capacity() >= size)
+            return;
+
+        BufferPool *pool;
+        auto data = BufferPool::acquire(size, pool);
+        data.assign(m_data.begin(), m_data.end());
+        BufferPool::release(m_pool, std::move(m_data));
+        m_pool = pool;
+        m_data = std::move(data);
+    }
 } // namespace Utilities
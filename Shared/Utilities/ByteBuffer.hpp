@@ -25,14 +25,23 @@
 
 namespace Utilities
 {
+    class BufferPool;
+
     class ByteBuffer
     {
     public:
         ByteBuffer();
         ByteBuffer(std::size_t size);
         ByteBuffer(MessageBuffer &&buffer);
+        ByteBuffer(const ByteBuffer &right) = delete;
+        ByteBuffer(ByteBuffer &&right) noexcept;
+        ~ByteBuffer();
+
+        ByteBuffer &operator=(const ByteBuffer &right) = delete;
+        ByteBuffer &operator=(ByteBuffer &&right) noexcept;
 
         std::size_t size() const;
+        std::size_t wpos() const;
         std::uint8_t *data();
         const std::uint8_t *data() const;
         bool empty();
@@ -54,13 +63,21 @@ namespace Utilities
             append(value.data(), Size);
         }
 
+        template <typename T> void put(std::size_t position, T value);
+
         void resize(std::size_t new_size);
+        std::vector<std::uint8_t> &&move();
+        BufferPool *pool() const { return m_pool; }
 
     private:
         static constexpr auto initial_size = 4096;
 
+        // Pool the storage is released to, null for storage adopted from outside the pools
+        BufferPool *m_pool{nullptr};
         std::vector<std::uint8_t> m_data;
         std::size_t m_write_pos{0};
         std::size_t m_read_pos{0};
+
+        void reserve(std::size_t size);
     };
 } // namespace Utilities
@@ -15,14 +15,47 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <Utilities/BufferPool.hpp>
+#include <Utilities/ByteBuffer.hpp>
 #include <Utilities/MessageBuffer.hpp>
 #include <cstring>
+#include <utility>
 
 namespace Utilities
 {
-    MessageBuffer::MessageBuffer() { m_data.resize(initial_size); }
+    MessageBuffer::MessageBuffer() : MessageBuffer(initial_size) {}
 
-    MessageBuffer::MessageBuffer(std::size_t size) { m_data.resize(size); }
+    MessageBuffer::MessageBuffer(std::size_t size) : m_data(BufferPool::acquire(size, m_pool)) { m_data.resize(size); }
+
+    MessageBuffer::MessageBuffer(std::vector<std::uint8_t> &&data) : m_data(std::move(data)), m_write_pos(m_data.size())
+    {
+    }
+
+    MessageBuffer::MessageBuffer(ByteBuffer &&buffer)
+        : m_pool(buffer.pool()), m_data(buffer.move()), m_write_pos(m_data.size())
+    {
+    }
+
+    MessageBuffer::MessageBuffer(MessageBuffer &&right) noexcept
+        : m_pool(std::exchange(right.m_pool, nullptr)), m_data(std::move(right.m_data)),
+          m_write_pos(std::exchange(right.m_write_pos, 0)), m_read_pos(std::exchange(right.m_read_pos, 0))
+    {
+    }
+
+    MessageBuffer::~MessageBuffer() { BufferPool::release(m_pool, std::move(m_data)); }
+
+    MessageBuffer &MessageBuffer::operator=(MessageBuffer &&right) noexcept
+    {
+        if (this == &right)
+            return *this;
+
+        BufferPool::release(m_pool, std::move(m_data));
+        m_pool = std::exchange(right.m_pool, nullptr);
+        m_data = std::move(right.m_data);
+        m_write_pos = std::exchange(right.m_write_pos, 0);
+        m_read_pos = std::exchange(right.m_read_pos, 0);
+        return *this;
+    }
 
     std::uint8_t *MessageBuffer::base_ptr() { return m_data.data(); }
 
@@ -57,7 +90,7 @@ namespace Utilities
         if (remaining_size() > 0)
             return;
 
-        m_data.resize(m_data.size() + initial_size);
+        grow(m_data.size() + initial_size);
     }
 
     void MessageBuffer::read_completed(std::size_t size) { m_read_pos += size; }
@@ -73,12 +106,30 @@ namespace Utilities
         write_completed(size);
     }
 
-    void MessageBuffer::resize(std::size_t size) { m_data.resize(size); }
+    void MessageBuffer::resize(std::size_t size)
+    {
+        if (size > m_data.capacity())
+            grow(size);
+        else
+            m_data.resize(size);
+    }
 
     std::vector<std::uint8_t> &&MessageBuffer::move()
     {
+        m_pool = nullptr;
         m_write_pos = 0;
         m_read_pos = 0;
         return std::move(m_data);
     }
+
+    void MessageBuffer::grow(std::size_t size)
+    {
+        BufferPool *pool;
+        auto data = BufferPool::acquire(size, pool);
+        data.assign(m_data.begin(), m_data.end());
+        data.resize(size);
+        BufferPool::release(m_pool, std::move(m_data));
+        m_pool = pool;
+        m_data = std::move(data);
+    }
 } // namespace Utilities
@@ -22,11 +22,22 @@
 
 namespace Utilities
 {
+    class BufferPool;
+    class ByteBuffer;
+
     class MessageBuffer
     {
     public:
         MessageBuffer();
         MessageBuffer(std::size_t size);
+        MessageBuffer(std::vector<std::uint8_t> &&data);
+        MessageBuffer(ByteBuffer &&buffer);
+        MessageBuffer(const MessageBuffer &right) = delete;
+        MessageBuffer(MessageBuffer &&right) noexcept;
+        ~MessageBuffer();
+
+        MessageBuffer &operator=(const MessageBuffer &right) = delete;
+        MessageBuffer &operator=(MessageBuffer &&right) noexcept;
 
         std::uint8_t *base_ptr();
         std::uint8_t *write_ptr();
@@ -41,12 +52,17 @@ namespace Utilities
         void write(const void *data, std::size_t size);
         void resize(std::size_t size);
         std::vector<std::uint8_t> &&move();
+        BufferPool *pool() const { return m_pool; }
 
     private:
         static constexpr auto initial_size = 4096;
 
+        // Pool the storage is released to, null for storage adopted from outside the pools
+        BufferPool *m_pool{nullptr};
         std::vector<std::uint8_t> m_data;
         std::size_t m_write_pos{0};
         std::size_t m_read_pos{0};
+
+        void grow(std::size_t size);
     };
 } // namespace Utilities
@@ -0,0 +1,108 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Crypto/BigNumber.hpp>
+#include <Crypto/FixedBaseTable.hpp>
+#include <Crypto/GenericHash.hpp>
+#include <Crypto/MontgomeryContext.hpp>
+#include <Crypto/Srp6.hpp>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <openssl/rand.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    template <std::size_t Size> std::array<std::uint8_t, Size> random_bytes()
+    {
+        std::array<std::uint8_t, Size> bytes;
+        RAND_bytes(bytes.data(), int(bytes.size()));
+        return bytes;
+    }
+} // namespace
+
+// Times g^b mod N for SRP6 exponents through BN_mod_exp, the cached Montgomery context and the fixed-base table, and
+// fails when the three disagree. Then times whole logon challenges, the Srp6 construction against the same steps
+// built on BN_mod_exp
+int main()
+{
+    constexpr int exponent_count = 2000;
+
+    Crypto::BigNumber g(Crypto::Srp6::g);
+    Crypto::BigNumber N(Crypto::Srp6::N);
+    Crypto::MontgomeryContext context(N);
+    Crypto::FixedBaseTable table(g, context, 8 * 32);
+
+    std::vector<Crypto::BigNumber> exponents;
+    for (int i = 0; i < exponent_count; i++)
+        exponents.emplace_back(random_bytes<32>());
+
+    auto measure = [&](const char *name, auto &&mod_exp, std::vector<Crypto::BigNumber> &results) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &exponent : exponents)
+            results.push_back(mod_exp(exponent));
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-20s %8.2f us per g^b\n", name, elapsed.count() / exponent_count);
+    };
+
+    std::vector<Crypto::BigNumber> plain;
+    std::vector<Crypto::BigNumber> montgomery;
+    std::vector<Crypto::BigNumber> fixed_base;
+    measure("BN_mod_exp", [&](const auto &exponent) { return g.mod_exp(exponent, N); }, plain);
+    measure("MontgomeryContext", [&](const auto &exponent) { return context.mod_exp(g, exponent); }, montgomery);
+    measure("FixedBaseTable", [&](const auto &exponent) { return table.mod_exp(exponent); }, fixed_base);
+
+    for (int i = 0; i < exponent_count; i++)
+    {
+        if (BN_cmp(plain[i].bn(), montgomery[i].bn()) || BN_cmp(plain[i].bn(), fixed_base[i].bn()))
+        {
+            std::printf("Mismatch on exponent %d\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // A challenge also hashes the username, draws b and adds k * v, the tables are built before timing starts
+    Crypto::Srp6::init();
+    const std::string username = "BENCHMARK";
+    const auto salt = random_bytes<Crypto::Srp6::salt_length>();
+    const auto verifier = random_bytes<Crypto::Srp6::verifier_length>();
+    const Crypto::BigNumber k(3u);
+    const Crypto::BigNumber v(verifier);
+
+    auto measure_challenges = [&](const char *name, auto &&challenge) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < exponent_count; i++)
+            challenge();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-20s %8.0f challenges per second\n", name, exponent_count / elapsed.count());
+    };
+
+    measure_challenges("BN_mod_exp", [&]() {
+        auto I = Crypto::SHA1::digest_of(username);
+        Crypto::BigNumber b(random_bytes<32>());
+        auto B = g.mod_exp(b, N);
+        Crypto::BigNumber kv(v);
+        kv.mod_mul(k, N);
+        return std::make_pair(I, B.mod_add(kv, N).to_byte_array<Crypto::Srp6::ephemeral_key_length>());
+    });
+    measure_challenges("Srp6", [&]() { return Crypto::Srp6(username, salt, verifier).B; });
+    return EXIT_SUCCESS;
+}
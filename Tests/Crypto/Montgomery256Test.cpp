@@ -0,0 +1,109 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Crypto/BigNumber.hpp>
+#include <Crypto/Montgomery256.hpp>
+#include <Crypto/Srp6.hpp>
+#include <array>
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <random>
+
+namespace
+{
+    using Bytes = std::array<std::uint8_t, Crypto::Uint256::byte_count>;
+
+    Bytes random_bytes(std::mt19937_64 &random)
+    {
+        Bytes bytes;
+        for (auto &byte : bytes)
+            byte = std::uint8_t(random());
+        return bytes;
+    }
+
+    Bytes reference(const Crypto::BigNumber &value) { return value.to_byte_array<Crypto::Uint256::byte_count>(); }
+
+    // Checks every operation of the field against OpenSSL BIGNUM arithmetic on the same little-endian bytes
+    void cross_check(const Bytes &modulus_bytes, std::mt19937_64 &random, int vectors)
+    {
+        Crypto::BigNumber modulus(modulus_bytes);
+        Crypto::Montgomery256 field{Crypto::Uint256(modulus_bytes)};
+        Crypto::Montgomery256::FixedBaseTable table(field, field.to_montgomery(Crypto::Uint256(7)));
+
+        for (int i = 0; i < vectors; i++)
+        {
+            auto a_bytes = random_bytes(random);
+            auto b_bytes = random_bytes(random);
+            auto e_bytes = random_bytes(random);
+            Crypto::BigNumber a(a_bytes);
+            Crypto::BigNumber b(b_bytes);
+            Crypto::BigNumber e(e_bytes);
+            auto a_reduced = a % modulus;
+            auto b_reduced = b % modulus;
+
+            auto a_mont = field.to_montgomery(Crypto::Uint256(a_bytes));
+            auto b_mont = field.to_montgomery(Crypto::Uint256(b_bytes));
+            Crypto::Uint256 exponent(e_bytes);
+
+            BOOST_TEST(field.from_montgomery(a_mont).to_byte_array<32>() == reference(a_reduced));
+            BOOST_TEST(field.from_montgomery(field.multiply(a_mont, b_mont)).to_byte_array<32>() ==
+                       reference((a * b) % modulus));
+            BOOST_TEST(field.from_montgomery(field.add(a_mont, b_mont)).to_byte_array<32>() ==
+                       reference((a_reduced + b_reduced) % modulus));
+            BOOST_TEST(field.from_montgomery(field.mod_exp(a_mont, exponent)).to_byte_array<32>() ==
+                       reference(a.mod_exp(e, modulus)));
+            BOOST_TEST(field.from_montgomery(table.mod_exp(exponent)).to_byte_array<32>() ==
+                       reference(Crypto::BigNumber(7u).mod_exp(e, modulus)));
+            BOOST_TEST(field.from_montgomery(field.mod_exp(a_mont, Crypto::Uint256())).to_byte_array<32>() ==
+                       reference(Crypto::BigNumber(1u) % modulus));
+        }
+    }
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Montgomery256)
+
+BOOST_AUTO_TEST_CASE(matches_openssl_modulo_srp6_prime)
+{
+    std::mt19937_64 random(6);
+    cross_check(Crypto::Srp6::N, random, 500);
+}
+
+BOOST_AUTO_TEST_CASE(matches_openssl_modulo_random_odd_moduli)
+{
+    std::mt19937_64 random(256);
+    for (int i = 0; i < 40; i++)
+    {
+        // Alternate full width moduli with ones whose top bit is clear, where reductions carry differently
+        auto modulus = random_bytes(random);
+        modulus[0] |= 1;
+        if (i % 2)
+            modulus[31] &= 0x7f;
+        else
+            modulus[31] |= 0x80;
+        cross_check(modulus, random, 50);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(matches_openssl_modulo_largest_modulus)
+{
+    std::mt19937_64 random(0);
+    Bytes modulus;
+    modulus.fill(0xff);
+    cross_check(modulus, random, 200);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE Srp6Allocation
+#include <Crypto/Srp6.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <openssl/rand.h>
+
+// glibc lets a program replace malloc, the replacements count calls while enabled and forward to the real allocator
+extern "C" void *__libc_malloc(std::size_t size);
+extern "C" void *__libc_calloc(std::size_t count, std::size_t size);
+extern "C" void *__libc_realloc(void *pointer, std::size_t size);
+
+namespace
+{
+    bool counting = false;
+    std::size_t allocations = 0;
+
+    // Handshakes once the per-thread context and the generator table are warm
+    constexpr std::size_t max_handshake_allocations = 32;
+} // namespace
+
+extern "C" void *malloc(std::size_t size)
+{
+    allocations += counting;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size)
+{
+    allocations += counting;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, std::size_t size)
+{
+    allocations += counting;
+    return __libc_realloc(pointer, size);
+}
+
+BOOST_AUTO_TEST_CASE(server_handshake_allocations)
+{
+    Crypto::Srp6::init();
+
+    Crypto::Srp6::Salt salt{};
+    Crypto::Srp6::Verifier verifier;
+    Crypto::Srp6::EphemeralKey A;
+    RAND_bytes(verifier.data(), int(verifier.size()));
+    RAND_bytes(A.data(), int(A.size()));
+    Crypto::SHA1::Digest proof{};
+
+    for (int i = 0; i < 4; i++)
+    {
+        allocations = 0;
+        counting = true;
+        Crypto::Srp6 server("PLAYER", salt, verifier);
+        auto key = server.verify_challenge(A, proof);
+        counting = false;
+
+        // The first handshake of a thread also creates its BN_CTX
+        BOOST_TEST_MESSAGE("handshake " << i << ", allocations = " << allocations);
+        if (i)
+            BOOST_TEST(allocations <= max_handshake_allocations);
+        BOOST_TEST(!key.has_value());
+    }
+}
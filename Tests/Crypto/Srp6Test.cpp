@@ -0,0 +1,132 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Crypto/BigNumber.hpp>
+#include <Crypto/Srp6.hpp>
+#include <algorithm>
+#include <array>
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <openssl/rand.h>
+#include <string>
+
+namespace
+{
+    template <std::size_t Size> std::array<std::uint8_t, Size> random_bytes()
+    {
+        std::array<std::uint8_t, Size> bytes;
+        RAND_bytes(bytes.data(), int(Size));
+        return bytes;
+    }
+
+    // Client side of the handshake on OpenSSL BIGNUM arithmetic, independent of the server backend
+    struct Client
+    {
+        std::string username{"PLAYER"};
+        Crypto::BigNumber N{Crypto::Srp6::N};
+        Crypto::BigNumber g{Crypto::Srp6::g};
+        Crypto::BigNumber x{random_bytes<Crypto::SHA1::disgest_length>()};
+        Crypto::BigNumber a{random_bytes<19>()};
+        Crypto::Srp6::Salt salt = random_bytes<Crypto::Srp6::salt_length>();
+        Crypto::Srp6::Verifier verifier = g.mod_exp(x, N).to_byte_array<Crypto::Srp6::verifier_length>();
+        Crypto::Srp6::EphemeralKey A = g.mod_exp(a, N).to_byte_array<Crypto::Srp6::ephemeral_key_length>();
+        Crypto::Srp6::SessionKey key{};
+
+        Crypto::SHA1::Digest proof(const Crypto::Srp6::EphemeralKey &B)
+        {
+            // S = (B - k * g^x)^(a + u * x) % N with k = 3
+            Crypto::BigNumber u(Crypto::SHA1::digest_of(A, B));
+            Crypto::BigNumber base = Crypto::BigNumber(B) - g.mod_exp(x, N) * Crypto::BigNumber(3u);
+            base %= N;
+            if (BN_is_negative(base.bn()))
+                base += N;
+            key = interleave(base.mod_exp(a + u * x, N).to_byte_array<Crypto::Srp6::ephemeral_key_length>());
+
+            auto n_hash = Crypto::SHA1::digest_of(Crypto::Srp6::N);
+            auto g_hash = Crypto::SHA1::digest_of(Crypto::Srp6::g);
+            Crypto::SHA1::Digest ng_hash;
+            std::transform(n_hash.begin(), n_hash.end(), g_hash.begin(), ng_hash.begin(), std::bit_xor<>());
+            return Crypto::SHA1::digest_of(ng_hash, Crypto::SHA1::digest_of(username), salt, A, B, key);
+        }
+
+        static Crypto::Srp6::SessionKey interleave(const Crypto::Srp6::EphemeralKey &S)
+        {
+            std::array<std::uint8_t, 16> even;
+            std::array<std::uint8_t, 16> odd;
+            for (std::size_t i = 0; i < 16; i++)
+            {
+                even[i] = S[2 * i];
+                odd[i] = S[2 * i + 1];
+            }
+
+            std::size_t skip = 0;
+            while (skip < S.size() && !S[skip])
+                skip++;
+            skip = (skip + 1) / 2;
+
+            auto even_hash = Crypto::SHA1::digest_of(even.data() + skip, even.size() - skip);
+            auto odd_hash = Crypto::SHA1::digest_of(odd.data() + skip, odd.size() - skip);
+            Crypto::Srp6::SessionKey key;
+            for (std::size_t i = 0; i < Crypto::SHA1::disgest_length; i++)
+            {
+                key[2 * i] = even_hash[i];
+                key[2 * i + 1] = odd_hash[i];
+            }
+            return key;
+        }
+    };
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(Srp6)
+
+BOOST_AUTO_TEST_CASE(handshake_derives_client_session_key)
+{
+    Crypto::Srp6::init();
+    for (int i = 0; i < 200; i++)
+    {
+        Client client;
+        Crypto::Srp6 server(client.username, client.salt, client.verifier);
+        auto proof = client.proof(server.B);
+
+        auto key = server.verify_challenge(client.A, proof);
+        BOOST_TEST_REQUIRE(key.has_value());
+        BOOST_TEST(*key == client.key);
+        BOOST_TEST(Crypto::Srp6::session_verifier(client.A, proof, *key) ==
+                   Crypto::SHA1::digest_of(client.A, proof, client.key));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(handshake_rejects_wrong_proof)
+{
+    Client client;
+    Crypto::Srp6 server(client.username, client.salt, client.verifier);
+    auto proof = client.proof(server.B);
+    proof[0] ^= 1;
+    BOOST_TEST(!server.verify_challenge(client.A, proof).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(handshake_rejects_zero_ephemeral_key)
+{
+    Client client;
+    Crypto::Srp6 server(client.username, client.salt, client.verifier);
+
+    // A multiple of N reduces to zero, which would pin the session key whatever the password
+    Crypto::Srp6::EphemeralKey A = Crypto::Srp6::N;
+    BOOST_TEST(!server.verify_challenge(A, client.proof(server.B)).has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Realm/RealmList.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    using BuildInformation = Realm::RealmList::BuildInformation;
+
+    constexpr std::uint32_t max_pre_bc_client_build = 6141;
+    constexpr std::uint32_t last_checked_build = 70000;
+
+    // The scan build lookups did before they were compiled into a table
+    const BuildInformation *linear_build_info(const std::vector<BuildInformation> &builds, std::uint32_t build)
+    {
+        auto found = std::find_if(builds.begin(), builds.end(), [build](const auto &entry) {
+            return entry.build == build;
+        });
+        return found != builds.end() ? &*found : nullptr;
+    }
+
+    Realm::RealmList::BuildFamily linear_build_family(const std::vector<BuildInformation> &builds,
+                                                      std::uint32_t build)
+    {
+        if (!linear_build_info(builds, build))
+            return Realm::RealmList::build_family_unknown;
+        return build <= max_pre_bc_client_build ? Realm::RealmList::build_family_pre_bc
+                                                : Realm::RealmList::build_family_post_bc;
+    }
+
+    template <typename Lookup> double measure(const std::vector<std::uint32_t> &clients, Lookup &&lookup)
+    {
+        constexpr int rounds = 2000;
+        std::uint32_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++)
+        {
+            for (auto build : clients)
+                found += lookup(build);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (found == 0)
+            std::printf("No client build was found\n");
+        return elapsed.count() / double(rounds * clients.size());
+    }
+} // namespace
+
+// Times build lookups of logon clients through RealmList against the linear scan, and fails on any build whose
+// information or family differs between the two
+int main()
+{
+    std::vector<BuildInformation> builds = {{5875, 1, 12, 1},  {6005, 1, 12, 2},  {6141, 1, 12, 3},
+                                            {8606, 2, 4, 3},   {12340, 3, 3, 5},  {15595, 4, 3, 4},
+                                            {18414, 5, 4, 8},  {5875, 1, 12, 1}};
+
+    auto realm_list = Realm::RealmList::instance();
+    realm_list->set_builds(builds);
+
+    for (std::uint32_t build = 0; build <= last_checked_build; build++)
+    {
+        auto expected = linear_build_info(builds, build);
+        auto actual = realm_list->build_info(build);
+        if (bool(expected) != bool(actual) || (actual && (actual->major != expected->major ||
+                                                          actual->minor != expected->minor ||
+                                                          actual->revision != expected->revision)) ||
+            realm_list->build_family(build) != linear_build_family(builds, build))
+        {
+            std::printf("Mismatch on build %u\n", build);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Mostly supported clients, with some unknown and out of range builds in between
+    std::vector<std::uint32_t> clients;
+    for (std::uint32_t i = 0; i < 64; i++)
+        clients.push_back(i % 8 == 7 ? 4000 + i * 331 : builds[i % 7].build);
+
+    auto linear = measure(clients, [&](std::uint32_t build) {
+        return linear_build_family(builds, build) != Realm::RealmList::build_family_unknown;
+    });
+    auto table = measure(clients, [&](std::uint32_t build) {
+        return realm_list->build_family(build) != Realm::RealmList::build_family_unknown;
+    });
+    std::printf("%-14s %8.2f ns per lookup\n", "linear scan", linear);
+    std::printf("%-14s %8.2f ns per lookup\n", "build table", table);
+    return EXIT_SUCCESS;
+}
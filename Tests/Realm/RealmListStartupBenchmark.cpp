@@ -0,0 +1,162 @@
+/**
+ * MableEmulator is a server emulator for World of Warcraft
+ * Copyright (C) 2022 Saullo Bretas Silva
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <Database/AuthDatabase.hpp>
+#include <Database/RowLoader.hpp>
+#include <Realm/RealmList.hpp>
+#include <Realm/RealmListSnapshot.hpp>
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using BuildInformation = Realm::RealmList::BuildInformation;
+
+    // CTest reports the benchmark as skipped rather than failed when there is no auth database to load from
+    constexpr int skip_return_code = 77;
+    constexpr int rounds = 200;
+    constexpr std::size_t batch_rows = 256;
+
+    struct RealmRow
+    {
+        std::uint32_t id;
+        std::string name;
+        std::string address;
+        std::string local_address;
+        std::string local_subnet_mask;
+        std::uint16_t port;
+        std::uint8_t type;
+        std::uint8_t flags;
+        std::uint8_t category;
+        float population;
+        std::uint32_t build;
+        std::uint64_t updated_at;
+    };
+
+    // Startup tables were converted a field at a time through the Field getters before the row loader
+    std::size_t load_builds_by_field()
+    {
+        std::vector<BuildInformation> builds;
+        Database::PreparedStatement statement(Database::auth_select_builds);
+        std::unique_ptr<Database::PreparedResultSet> query(Database::AuthDatabase::instance()->query(statement));
+        if (!query)
+            return 0;
+
+        do
+        {
+            auto fields = query->fetch();
+            auto &build = builds.emplace_back();
+            build.build = fields[0].get_uint32();
+            build.major = fields[1].get_uint32();
+            build.minor = fields[2].get_uint32();
+            build.revision = fields[3].get_uint32();
+        } while (query->next_row());
+        return builds.size();
+    }
+
+    std::size_t load_realms_by_field()
+    {
+        std::vector<RealmRow> rows;
+        Database::PreparedStatement statement(Database::auth_select_realms);
+        std::unique_ptr<Database::PreparedResultSet> query(Database::AuthDatabase::instance()->query(statement));
+        if (!query)
+            return 0;
+
+        do
+        {
+            auto fields = query->fetch();
+            auto &row = rows.emplace_back();
+            row.id = fields[0].get_uint32();
+            row.name = fields[1].get_string();
+            row.address = fields[2].get_string();
+            row.local_address = fields[3].get_string();
+            row.local_subnet_mask = fields[4].get_string();
+            row.port = fields[5].get_uint16();
+            row.type = fields[6].get_uint8();
+            row.flags = fields[7].get_uint8();
+            row.category = fields[8].get_uint8();
+            row.population = fields[9].get_float();
+            row.build = fields[10].get_uint32();
+            row.updated_at = fields[11].get_uint64();
+        } while (query->next_row());
+        return rows.size();
+    }
+
+    template <typename Load> void measure(const char *name, Load &&load)
+    {
+        std::size_t rows = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++)
+            rows = load();
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-24s %6zu rows %10.1f us per load\n", name, rows, elapsed.count() / rounds);
+    }
+} // namespace
+
+// Times loading the startup tables from the auth database field by field, through the buffered row loader and
+// streamed in column batches, then the whole realm list startup up to its first published list
+int main()
+{
+    auto database = Database::AuthDatabase::instance();
+    if (database->open())
+    {
+        std::printf("No auth database to load the startup tables from\n");
+        return skip_return_code;
+    }
+
+    Database::RowLoader build_loader(&BuildInformation::build, &BuildInformation::major, &BuildInformation::minor,
+                                     &BuildInformation::revision);
+    Database::RowLoader realm_loader(&RealmRow::id, &RealmRow::name, &RealmRow::address, &RealmRow::local_address,
+                                     &RealmRow::local_subnet_mask, &RealmRow::port, &RealmRow::type,
+                                     &RealmRow::flags, &RealmRow::category, &RealmRow::population, &RealmRow::build,
+                                     &RealmRow::updated_at);
+
+    measure("builds by field", load_builds_by_field);
+    measure("builds row loader", [&]() {
+        std::vector<BuildInformation> builds;
+        build_loader.load(*database, Database::PreparedStatement(Database::auth_select_builds), builds);
+        return builds.size();
+    });
+    measure("realms by field", load_realms_by_field);
+    measure("realms row loader", [&]() {
+        std::vector<RealmRow> rows;
+        realm_loader.load(*database, Database::PreparedStatement(Database::auth_select_realms), rows);
+        return rows.size();
+    });
+    measure("realms streamed", [&]() {
+        std::vector<RealmRow> rows;
+        realm_loader.load(*database, Database::PreparedStatement(Database::auth_select_realms), rows, batch_rows);
+        return rows.size();
+    });
+
+    boost::asio::io_context io_context(1);
+    auto start = std::chrono::steady_clock::now();
+    auto realm_list = Realm::RealmList::instance();
+    realm_list->init(io_context);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    auto snapshot = realm_list->snapshot();
+    std::printf("%-24s %6zu realms %8.2f ms\n", "realm list startup", snapshot ? snapshot->realms().size() : 0,
+                elapsed.count());
+
+    database->close();
+    return snapshot ? EXIT_SUCCESS : EXIT_FAILURE;
+}